@@ -6,6 +6,8 @@
 
 #include "public/fpdf_missing.h"
 
+#include <algorithm>
+
 #include "fpdfsdk/include/fsdk_define.h"
 #include "core/fpdfapi/fpdf_page/include/cpdf_form.h"
 #include "core/fpdfapi/fpdf_page/include/cpdf_formobject.h"
@@ -13,6 +15,9 @@
 #include "core/fpdfapi/fpdf_page/include/cpdf_pageobject.h"
 #include "core/fpdfapi/fpdf_page/include/cpdf_pathobject.h"
 #include "core/fpdfapi/fpdf_parser/include/cpdf_array.h"
+#include "core/fpdfapi/fpdf_parser/include/cpdf_dictionary.h"
+#include "core/fpdfapi/fpdf_parser/include/cpdf_document.h"
+#include "core/fpdftext/include/cpdf_textpage.h"
 
 DLLEXPORT FPDF_DOCUMENT STDCALL FPDF_LoadDocumentW(FPDF_WIDESTRING file_path, FPDF_BYTESTRING password)
 {
@@ -222,3 +227,120 @@ DLLEXPORT void STDCALL FPDF_GetPageMatrix(FPDF_PAGE page,
   *e = m.e;
   *f = m.f;
 }
+
+DLLEXPORT FPDF_BOOL STDCALL FPDF_GetPageGeometryByIndex(FPDF_DOCUMENT document,
+                                                        int page_index,
+                                                        double *width, double *height,
+                                                        int *rotation,
+                                                        double *a, double *b, double *c,
+                                                        double *d, double *e, double *f)
+{
+  if( !width  ||  !height  ||  !rotation  ||
+      !a  ||  !b  ||  !c  ||  !d  ||  !e  ||  !f ) {
+    return FALSE;
+  }
+
+  CPDF_Document *pDoc = CPDFDocumentFromFPDFDocument(document);
+  if( !pDoc  ||  page_index < 0  ||  page_index >= pDoc->GetPageCount() ) {
+    return FALSE;
+  }
+
+  CPDF_Dictionary *pDict = pDoc->GetPage(page_index);
+  if( !pDict ) {
+    return FALSE;
+  }
+
+  CPDF_Page page(pDoc, pDict, true);
+
+  CPDF_Object *pRotate = page.GetPageAttr("Rotate");
+  int rotate = pRotate ? pRotate->GetInteger() / 90 % 4 : 0;
+  if( rotate < 0 ) {
+    rotate += 4;
+  }
+
+  *width    = page.GetPageWidth();
+  *height   = page.GetPageHeight();
+  *rotation = rotate;
+
+  const CFX_Matrix& m = page.GetPageMatrix();
+  *a = m.a;
+  *b = m.b;
+  *c = m.c;
+  *d = m.d;
+  *e = m.e;
+  *f = m.f;
+
+  return TRUE;
+}
+
+namespace {
+
+  // cf. "fpdf_text_int.cpp"
+  const int32_t kCharGenerated = 1; // FPDFTEXT_CHAR_GENERATED
+
+  // NOTE: Matches QChar::isSpace()
+  bool isSeparator(const FX_WCHAR c)
+  {
+    return c == 0  ||  c == 0x20  ||  (c >= 0x09  &&  c <= 0x0D)  ||
+        c == 0x85  ||  c == 0xA0  ||  c == 0x1680  ||
+        (c >= 0x2000  &&  c <= 0x200A)  ||  c == 0x2028  ||  c == 0x2029  ||
+        c == 0x202F  ||  c == 0x205F  ||  c == 0x3000;
+  }
+
+} // namespace
+
+DLLEXPORT int STDCALL FPDFText_GetCharsBulk(FPDF_TEXTPAGE text_page,
+                                            int start_index, int count,
+                                            unsigned int *unicodes,
+                                            float *boxes,
+                                            float *font_sizes,
+                                            unsigned char *flags)
+{
+  if( !text_page ) {
+    return 0;
+  }
+
+  const CPDF_TextPage *textpage = static_cast<CPDF_TextPage*>(text_page);
+
+  const int numChars = textpage->CountChars();
+  if( start_index < 0  ||  start_index >= numChars  ||  count < 1 ) {
+    return 0;
+  }
+  count = std::min(count, numChars - start_index);
+
+  FPDF_CHAR_INFO info;
+  for(int i = 0; i < count; i++) {
+    textpage->GetCharInfo(start_index + i, &info);
+
+    if( unicodes ) {
+      unicodes[i] = info.m_Unicode;
+    }
+
+    if( boxes ) {
+      boxes[4*i + 0] = info.m_CharBox.left;
+      boxes[4*i + 1] = info.m_CharBox.top;
+      boxes[4*i + 2] = info.m_CharBox.right;
+      boxes[4*i + 3] = info.m_CharBox.bottom;
+    }
+
+    if( font_sizes ) {
+      font_sizes[i] = info.m_FontSize;
+    }
+
+    if( flags ) {
+      unsigned char f = 0;
+      if( isSeparator(info.m_Unicode) ) {
+        f |= FPDF_TEXTCHAR_SEPARATOR;
+      }
+      if( info.m_Unicode == 0x0D  ||  info.m_Unicode == 0x0A ) {
+        f |= FPDF_TEXTCHAR_LINEBREAK;
+      }
+      if( info.m_Flag == kCharGenerated ) {
+        f |= FPDF_TEXTCHAR_GENERATED;
+      }
+      flags[i] = f;
+    }
+  }
+
+  return count;
+}
@@ -63,6 +63,28 @@ DLLEXPORT void STDCALL FPDF_GetPageMatrix(FPDF_PAGE page,
                                           double *a, double *b, double *c,
                                           double *d, double *e, double *f);
 
+// NOTE: Like FPDF_GetPageSizeByIndex(); the page's content is NOT parsed.
+DLLEXPORT FPDF_BOOL STDCALL FPDF_GetPageGeometryByIndex(FPDF_DOCUMENT document,
+                                                        int page_index,
+                                                        double *width, double *height,
+                                                        int *rotation,
+                                                        double *a, double *b, double *c,
+                                                        double *d, double *e, double *f);
+
+#define FPDF_TEXTCHAR_SEPARATOR  1 // Whitespace or NUL; ends a word
+#define FPDF_TEXTCHAR_LINEBREAK  2 // CR or LF
+#define FPDF_TEXTCHAR_GENERATED  4 // Inserted by the text extraction
+
+// NOTE: Fills 'count' characters starting at 'start_index' in ONE call;
+//       'boxes' holds 4 floats per character: left, top, right, bottom.
+//       Any of the arrays may be NULL. Returns the number of characters.
+DLLEXPORT int STDCALL FPDFText_GetCharsBulk(FPDF_TEXTPAGE text_page,
+                                            int start_index, int count,
+                                            unsigned int *unicodes,
+                                            float *boxes,
+                                            float *font_sizes,
+                                            unsigned char *flags);
+
 #ifdef __cplusplus
 }
 #endif
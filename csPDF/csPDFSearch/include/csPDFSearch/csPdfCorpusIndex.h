@@ -0,0 +1,146 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFCORPUSINDEX_H
+#define CSPDFCORPUSINDEX_H
+
+#include <QCache>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QMap>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+
+#include <csPDFSearch/cspdfsearch_config.h>
+#include <csPDFSearch/csPdfSearchIndex.h>
+#include <csPDFSearch/csPdfSearchResult.h>
+
+struct csPdfCorpusEntry {
+  csPdfCorpusEntry()
+    : fileName()
+    , size(-1)
+    , modified()
+    , key()
+    , pageCount(-1)
+  {
+  }
+
+  // NOTE: Invalid entries are kept; an unchanged broken file is not retried.
+  inline bool isValid() const
+  {
+    return !key.isEmpty()  &&  pageCount > 0;
+  }
+
+  inline bool isCurrent(const QFileInfo& info) const
+  {
+    return size == info.size()  &&  modified == info.lastModified();
+  }
+
+  QString    fileName;
+  qint64     size;
+  QDateTime  modified;
+  QByteArray key;       // Names the document's shard; cf. csPdfSearchIndex
+  int        pageCount;
+};
+
+typedef QList<csPdfCorpusEntry> csPdfCorpusEntries;
+
+typedef QPair<QString,csPdfSearchResults> csPdfCorpusResult; // File & its Hits
+typedef QList<csPdfCorpusResult>          csPdfCorpusResults;
+
+#define CSPDF_CORPUS_SHARDS  16 // Opened Shards Kept by index()
+
+// NOTE: Every document is a shard, i.e. a csPdfSearchIndex file shared with
+//       csPdfSearch; a manifest per root directory tracks the indexed files.
+class CS_PDFSEARCH_EXPORT csPdfCorpusIndex : public QObject {
+  Q_OBJECT
+public:
+  csPdfCorpusIndex(const QString& rootDir,
+                   const QString& indexDir = csPdfSearchIndex::defaultDirectory(),
+                   QObject *parent = nullptr);
+  ~csPdfCorpusIndex();
+
+  bool isRunning() const;
+  QString rootDirectory() const;
+  QString indexDirectory() const;
+  csPdfCorpusEntries entries() const;
+  QStringList fileNames() const; // Valid entries only
+  // NOTE: Crawls the root directory & indexes new or changed files only.
+  //       Afterwards the shards of changed & removed files are deleted,
+  //       unless another manifest in the index directory refers to them.
+  bool update(const QStringList& nameFilters = QStringList(QStringLiteral("*.pdf")));
+  // NOTE: Same semantics as csPdfSearch; results are ordered by file.
+  //       Blocks until all shards are searched; cf. findAsync().
+  csPdfCorpusResults find(const QStringList& needles,
+                          const Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+  // NOTE: Searches on csPDFium::textThreadPool(); a result per file with
+  //       hits, in no particular order.
+  QFuture<csPdfCorpusResult> findAsync(const QStringList& needles,
+                                       const Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+  // NOTE: The file's shard, e.g. for csPdfSearchTextCache; the most recently
+  //       used CSPDF_CORPUS_SHARDS shards are kept open.
+  csPdfSearchIndex index(const QString& filename) const;
+
+public slots:
+  void cancel();
+
+signals:
+  void canceled();
+  void finished();
+  void processed(int value);
+  void started();
+
+private slots:
+  void finishUpdate();
+  void progressUpdate(int value);
+  void storeEntry(int index);
+
+private:
+  bool loadManifest();
+  QString manifestFileName() const;
+  csPdfSearchIndex openShard(const csPdfCorpusEntry& entry) const;
+  void removeStaleShards();
+  bool saveManifest() const;
+
+  QString _rootDir;
+  QString _indexDir;
+  QMap<QString,csPdfCorpusEntry> _entries; // By File
+  QFutureWatcher<csPdfCorpusEntry> *_watcher;
+  mutable QCache<QByteArray,csPdfSearchIndex> _shards; // By Key
+  QSet<QByteArray> _stale; // Keys of changed & removed files
+  int _lastProgress;
+};
+
+#endif // CSPDFCORPUSINDEX_H
@@ -0,0 +1,137 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFMATCHER_H
+#define CSPDFMATCHER_H
+
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <csPDFSearch/cspdfsearch_config.h>
+#include <csPDFium/csPDFiumText.h>
+
+// NOTE: A needle compiled once; case insensitive needles are case folded once,
+//       i.e. the haystack MUST be prepared likewise, cf. csPdfMatchText.
+class CS_PDFSEARCH_EXPORT csPdfMatcher {
+public:
+  csPdfMatcher(const QString& needle = QString(),
+               const Qt::CaseSensitivity cs = Qt::CaseSensitive);
+  ~csPdfMatcher();
+
+  bool isEmpty() const;
+  Qt::CaseSensitivity caseSensitivity() const;
+  const QString& pattern() const;
+  int size() const;
+
+  int indexIn(const QChar *hay, const int size, const int from = 0) const;
+  bool equals(const QChar *s, const int size) const;
+  bool isPrefixOf(const QChar *s, const int size) const;
+  bool isSuffixOf(const QChar *s, const int size) const;
+
+  static QString prepare(const QString& s, const Qt::CaseSensitivity cs);
+
+private:
+  QString _pattern;
+  Qt::CaseSensitivity _cs;
+  QVector<int> _skip; // Horspool
+};
+
+typedef QList<csPdfMatcher> csPdfMatchers;
+
+CS_PDFSEARCH_EXPORT csPdfMatchers csPdfCompileMatchers(const QStringList& needles,
+                                                       const Qt::CaseSensitivity cs);
+
+// NOTE: A page's words joined into one prepared text, separated by a space;
+//       built once per page & shared by all needles.
+class CS_PDFSEARCH_EXPORT csPdfMatchText {
+public:
+  csPdfMatchText(const csPDFiumTexts& texts = csPDFiumTexts(),
+                 const Qt::CaseSensitivity cs = Qt::CaseSensitive);
+  csPdfMatchText(const QStringList& words,
+                 const Qt::CaseSensitivity cs = Qt::CaseSensitive);
+  ~csPdfMatchText();
+
+  Qt::CaseSensitivity caseSensitivity() const;
+  int count() const;
+  const QString& text() const;
+
+  int wordAt(const int pos) const;
+  int wordStart(const int i) const;
+  int wordEnd(const int i) const; // Exclusive
+
+private:
+  void append(const QString& word);
+
+  Qt::CaseSensitivity _cs;
+  QString _text;
+  QVector<int> _starts; // count()+1 Entries
+};
+
+typedef QPair<int,int>           csPdfMultiMatch; // (Word, Pattern)
+typedef QList<csPdfMultiMatch> csPdfMultiMatches;
+
+// NOTE: Aho-Corasick automaton over many phrases, built once; a phrase's words
+//       are joined by a space, i.e. they match like csPdfFindAll() does with
+//       csPdfPrepareSearch()'ed needles. Ids are the phrases' list indices.
+class CS_PDFSEARCH_EXPORT csPdfMultiMatcher {
+public:
+  csPdfMultiMatcher(const QStringList& patterns = QStringList(),
+                    const Qt::CaseSensitivity cs = Qt::CaseSensitive);
+  ~csPdfMultiMatcher();
+
+  bool isEmpty() const;
+  Qt::CaseSensitivity caseSensitivity() const;
+  int count() const;
+  const QString& pattern(const int id) const;
+  int wordCount(const int id) const;
+
+  // NOTE: One match per pattern & starting word, ordered by (word, pattern).
+  csPdfMultiMatches findAll(const csPdfMatchText& hay) const;
+
+private:
+  int transition(const int node, const QChar c) const;
+
+  Qt::CaseSensitivity _cs;
+  QStringList _patterns;  // Prepared
+  QVector<int> _words;    // Per Pattern
+  QVector<int> _same;     // Per Pattern; next pattern ending in the same node
+  QVector<int> _first;    // Per Node+1; into _labels & _targets
+  QVector<ushort> _labels;
+  QVector<int> _targets;
+  QVector<int> _fail;     // Per Node
+  QVector<int> _output;   // Per Node; first pattern ending here
+  QVector<int> _dict;     // Per Node; nearest suffix node with output
+};
+
+#endif // CSPDFMATCHER_H
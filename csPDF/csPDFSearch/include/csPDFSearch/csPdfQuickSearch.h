@@ -0,0 +1,96 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFQUICKSEARCH_H
+#define CSPDFQUICKSEARCH_H
+
+#include <QFutureWatcher>
+#include <QList>
+#include <QObject>
+#include <QRectF>
+#include <QSharedPointer>
+
+#include <csPDFSearch/cspdfsearch_config.h>
+#include <csPDFium/csPDFiumDocument.h>
+#include <csPDFSearch/csPdfSearchResult.h>
+
+class csPdfQuickSearchState;
+class csPdfSearch;
+struct csPdfQuickSearchHits;
+
+// NOTE: Search-as-you-type; the current page is searched off the caller's
+//       thread & a query extending the previous one narrows down its hits.
+//       The whole document is searched next, cf. csPdfSearch.
+class CS_PDFSEARCH_EXPORT csPdfQuickSearch : public QObject {
+  Q_OBJECT
+public:
+  csPdfQuickSearch(QObject *parent = nullptr);
+  ~csPdfQuickSearch();
+
+  Qt::CaseSensitivity caseSensitivity() const;
+  void setCaseSensitivity(const Qt::CaseSensitivity cs);
+  const csPDFiumDocument& document() const;
+  void setDocument(const csPDFiumDocument& doc);
+  QString text() const;
+
+public slots:
+  void cancel();
+  void find(const QString& text);
+  void setPage(int no); // [1, document().pageCount()]
+
+signals:
+  void found(const csPdfSearchResults& results); // Current page; replaces previous
+  void highlightRequested(const QList<QRectF>& rects); // Of found(); page coordinates
+  void documentFound(const csPdfSearchResults& results); // Adds to previous
+  void documentFinished(int count);
+
+private slots:
+  void finishDocument();
+  void finishPage();
+  void restartDocument();
+  void storeDocumentResults(const csPdfSearchResults& results);
+
+private:
+  void startDocument();
+  void startPage();
+
+  csPDFiumDocument _doc;
+  int _pageNo; // 0-based
+  Qt::CaseSensitivity _cs;
+  QString _text;
+  QSharedPointer<csPdfQuickSearchState> _state;
+  QFutureWatcher<csPdfQuickSearchHits> *_watcher;
+  csPdfSearch *_search;
+  bool _restartDocument;
+  int _numDocumentHits;
+};
+
+#endif // CSPDFQUICKSEARCH_H
@@ -32,12 +32,25 @@
 #ifndef CSPDFSEARCH_H
 #define CSPDFSEARCH_H
 
+#include <QFutureWatcher>
+#include <QList>
+#include <QMap>
 #include <QObject>
+#include <QPair>
+#include <QRegularExpression>
+#include <QSharedPointer>
 
 #include <csPDFSearch/cspdfsearch_config.h>
 #include <csPDFium/csPDFiumDocument.h>
+#include <csPDFSearch/csPdfMatcher.h>
+#include <csPDFSearch/csPdfSearchIndex.h>
 #include <csPDFSearch/csPdfSearchResult.h>
 
+class csPdfSearchIndexBuilder;
+
+typedef QPair<int,csPdfMatchText> csPdfSearchPage; // (Page, Text)
+typedef QList<csPdfSearchPage>    csPdfSearchPages;
+
 class CS_PDFSEARCH_EXPORT csPdfSearch : public QObject {
   Q_OBJECT
 public:
@@ -45,10 +58,28 @@ public:
   ~csPdfSearch();
 
   bool isRunning() const;
+  // NOTE: An empty directory, the default, disables the search index; cf.
+  //       csPdfSearchIndex::defaultDirectory().
+  QString indexDirectory() const;
+  void setIndexDirectory(const QString& dir);
+  // NOTE: Pages are searched in blocks on csPDFium::textThreadPool().
+  //       Loading & extracting a page is serialized by the document; workers
+  //       only overlap the matching. Results are reported in search order.
+  //       Qt::MatchRegExp matches the needles, joined by a space, as a regular
+  //       expression against the page's words, joined likewise.
   bool start(const csPDFiumDocument& doc, const QStringList& needles,
              const int startIndex = 0,
-             const Qt::MatchFlags flags = Qt::MatchFlags(Qt::MatchCaseSensitive | Qt::MatchWrap),
-             const int context = 0);
+             const Qt::MatchFlags flags = Qt::MatchFlags(Qt::MatchCaseSensitive | Qt::MatchWrap));
+  // NOTE: Qt::MatchRegExp uses 'text' verbatim, i.e. its whitespace is kept;
+  //       otherwise 'text' is split into needles by csPdfPrepareSearch().
+  bool start(const csPDFiumDocument& doc, const QString& text,
+             const int startIndex = 0,
+             const Qt::MatchFlags flags = Qt::MatchFlags(Qt::MatchCaseSensitive | Qt::MatchWrap));
+  // NOTE: Many phrases in one pass over each page; results carry the
+  //       phrase's index as their pattern().
+  bool startPatterns(const csPDFiumDocument& doc, const QStringList& patterns,
+                     const int startIndex = 0,
+                     const Qt::MatchFlags flags = Qt::MatchFlags(Qt::MatchCaseSensitive | Qt::MatchWrap));
 
 public slots:
   void cancel();
@@ -61,34 +92,50 @@ signals:
   void processed(int value);
   void started();
 
+private slots:
+  void finishSearch();
+  void openedIndex();
+  void storeProgress(int value);
+  void storeResults(int block);
+
 private:
-  Q_INVOKABLE void processSearch();
-  void initialize(const int start, const int count);
-  bool isBlocksFinished() const;
-  bool isRemainFinished() const;
-  bool isFinished();
+  bool launch(const csPDFiumDocument& doc,
+              const QStringList& needles, const QStringList& patterns,
+              const QRegularExpression& regexp,
+              const int startIndex, const Qt::MatchFlags flags);
+  Q_INVOKABLE void prepareSearch();
+  void searchDocument(const csPdfSearchIndex& index = csPdfSearchIndex());
+  void searchIndex();
+  void writeIndex();
   void progressUpdate();
-  csPdfSearchResults searchPages(const csPDFiumTextPages& hay,
-                                 const QStringList& needles,
-                                 const Qt::CaseSensitivity cs,
-                                 const int context);
+  static csPdfSearchResults searchPages(const csPdfSearchPages& hay,
+                                        const csPdfMatchers& needles);
+  static csPdfSearchResults searchPages(const csPdfSearchPages& hay,
+                                        const csPdfMultiMatcher& patterns);
+  static csPdfSearchResults searchPages(const csPdfSearchPages& hay,
+                                        const QRegularExpression& regexp);
 
   csPDFiumDocument _doc;
   QStringList _needles;
+  QStringList _patterns;
+  QRegularExpression _regexp;
   Qt::CaseSensitivity _cs;
   bool _wrap;
-  int _context;
   volatile bool _cancel;
   volatile bool _running;
   int _startIndex;
-  int _numBlocks;
-  int _numRemain;
-  int _cntBlocks;
-  int _cntRemain;
-  int _cntIndex;
   int _numToDo;
   int _cntDone;
   int _lastProgress;
+  QString _indexDir;
+  csPdfSearchIndex _index;
+  QSharedPointer<csPdfSearchIndexBuilder> _builder;
+  QFutureWatcher<csPdfSearchResults> *_watcher;
+  QFutureWatcher<csPdfSearchIndex> *_indexWatcher;
+  QMap<int,csPdfSearchResults> _pending; // Blocks arrived out of order
+  int _nextBlock;
+
+  friend class csPdfSearchTask;
 };
 
 #endif // CSPDFSEARCH_H
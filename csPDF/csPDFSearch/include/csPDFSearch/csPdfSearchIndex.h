@@ -0,0 +1,79 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFSEARCHINDEX_H
+#define CSPDFSEARCHINDEX_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+#include <csPDFSearch/cspdfsearch_config.h>
+#include <csPDFium/csPDFiumDocument.h>
+#include <csPDFSearch/csPdfSearchResult.h>
+
+class csPdfSearchIndexImpl;
+
+// NOTE: Inverted index with positional postings of a document's words, i.e.
+//       of csPDFiumTextPage::texts(). The index file is keyed by the SHA-1 of
+//       the document's contents & memory-mapped on open.
+class CS_PDFSEARCH_EXPORT csPdfSearchIndex {
+public:
+  csPdfSearchIndex();
+  ~csPdfSearchIndex();
+
+  bool isEmpty() const;
+  void clear();
+  QString fileName() const;
+  QByteArray key() const;
+  int pageCount() const;
+  int termCount() const;
+  QStringList words(const int page) const;
+  // NOTE: Same semantics as csPdfFindAll(); results are ordered by page.
+  csPdfSearchResults find(const QStringList& needles,
+                          const Qt::CaseSensitivity cs = Qt::CaseSensitive) const;
+
+  static QString defaultDirectory();
+  static QByteArray documentKey(const QString& filename);
+  static QString indexFileName(const QString& dir, const QByteArray& key);
+
+  static bool build(const csPDFiumDocument& doc,
+                    const QString& dir = defaultDirectory());
+  static csPdfSearchIndex open(const csPDFiumDocument& doc,
+                               const QString& dir = defaultDirectory());
+  static csPdfSearchIndex open(const QString& filename,
+                               const QByteArray& key = QByteArray());
+
+private:
+  QSharedPointer<csPdfSearchIndexImpl> impl;
+};
+
+#endif // CSPDFSEARCHINDEX_H
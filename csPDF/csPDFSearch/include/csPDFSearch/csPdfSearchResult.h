@@ -32,17 +32,20 @@
 #ifndef CSPDFSEARCHRESULT_H
 #define CSPDFSEARCHRESULT_H
 
-#include <QStringList>
+#include <QVector>
 
 #include <csPDFium/csPDFiumUtil.h>
 
+// NOTE: A hit's 'span' words starting at word 'index' of page 'page'; the
+//       context is looked up on demand, cf. csPdfSearchTextCache.
 class csPdfSearchResult {
 public:
   inline csPdfSearchResult(const int pg = -1, const int idx = -1,
-                           const QStringList& ctx = QStringList())
+                           const int spn = 1, const int pat = 0)
     : _page(pg)
     , _index(idx)
-    , _context(ctx)
+    , _span(spn)
+    , _pattern(pat)
   {
   }
 
@@ -52,7 +55,7 @@ public:
 
   inline bool isEmpty() const
   {
-    return _page < 0  ||  _index < 0  ||  _context.isEmpty();
+    return _page < 0  ||  _index < 0  ||  _span < 1;
   }
 
   inline int page() const
@@ -65,32 +68,37 @@ public:
     return _index;
   }
 
-  inline const QStringList context() const
+  inline int span() const
   {
-    return _context;
+    return _span;
   }
 
-  inline const QString contextString() const
+  // NOTE: Index of the matching pattern; cf. csPdfSearch::startPatterns().
+  inline int pattern() const
   {
-    return _context.join(_L1C(' '));
+    return _pattern;
   }
 
   inline bool operator<(const csPdfSearchResult& other) const
   {
     return
         _page <  other._page  ||
-        (_page == other._page  &&  _index < other._index);
+        (_page == other._page  &&  _index <  other._index)  ||
+        (_page == other._page  &&  _index == other._index  &&  _pattern < other._pattern);
   }
 
 private:
   int _page;
   int _index;
-  QStringList _context;
+  int _span;
+  int _pattern;
 };
 
-typedef QList<csPdfSearchResult>                       csPdfSearchResults;
-typedef QList<csPdfSearchResult>::iterator             csPdfSearchResultIter;
-typedef QList<csPdfSearchResult>::const_iterator  csConstPdfSearchResultIter;
+Q_DECLARE_TYPEINFO(csPdfSearchResult, Q_MOVABLE_TYPE);
+
+typedef QVector<csPdfSearchResult>                     csPdfSearchResults;
+typedef QVector<csPdfSearchResult>::iterator           csPdfSearchResultIter;
+typedef QVector<csPdfSearchResult>::const_iterator csConstPdfSearchResultIter;
 
 Q_DECLARE_METATYPE(csPdfSearchResults)
 
@@ -33,9 +33,13 @@
 #define CSPDFSEARCHRESULTSMODEL_H
 
 #include <QAbstractTableModel>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QVector>
 
 #include <csPDFSearch/cspdfsearch_config.h>
 #include <csPDFSearch/csPdfSearchResult.h>
+#include <csPDFSearch/csPdfSearchTextCache.h>
 
 class CS_PDFSEARCH_EXPORT csPdfSearchResultsModel : public QAbstractTableModel {
   Q_OBJECT
@@ -50,12 +54,30 @@ public:
   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
   int rowCount(const QModelIndex& parent = QModelIndex()) const;
 
+  csPdfSearchResult result(const int row) const;
+  // NOTE: Context is looked up when displayed, i.e. for visible rows only;
+  //       a page missing from the cache is loaded in the background & its
+  //       rows are updated upon arrival.
+  csPdfSearchTextCache textCache() const;
+  void setTextCache(const csPdfSearchTextCache& cache, const int contextWidth = 2);
+
 public slots:
   void clear();
+  // NOTE: Batches are merged in order of (page, index, pattern); existing
+  //       rows keep their relative order, i.e. views keep their position.
   void insertResults(const csPdfSearchResults& incoming);
 
+private slots:
+  void showContext();
+
 private:
-  csPdfSearchResults _results;
+  void cancelContexts();
+  void requestContext(const int page) const;
+
+  csPdfSearchResults _rows;
+  csPdfSearchTextCache _cache;
+  int _contextWidth;
+  mutable QHash<int,QFutureWatcher<int>*> _loading; // By Page
 };
 
 #endif // CSPDFSEARCHRESULTSMODEL_H
@@ -0,0 +1,85 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFSEARCHTEXTCACHE_H
+#define CSPDFSEARCHTEXTCACHE_H
+
+#include <QFuture>
+#include <QList>
+#include <QRectF>
+#include <QSharedPointer>
+#include <QStringList>
+
+#include <csPDFSearch/cspdfsearch_config.h>
+#include <csPDFium/csPDFiumDocument.h>
+#include <csPDFSearch/csPdfSearchIndex.h>
+#include <csPDFSearch/csPdfSearchResult.h>
+
+class csPdfSearchTextCacheImpl;
+struct csPdfSearchPageText;
+
+// NOTE: The words of recently used pages, shared by all copies; the words
+//       come from the index, if given, or from the document's text pages.
+// CAUTION: A miss loads the page, i.e. contends with the document's workers;
+//          GUI threads check contains() & loadAsync() instead.
+class CS_PDFSEARCH_EXPORT csPdfSearchTextCache {
+public:
+  csPdfSearchTextCache();
+  csPdfSearchTextCache(const csPDFiumDocument& doc,
+                       const csPdfSearchIndex& index = csPdfSearchIndex());
+  ~csPdfSearchTextCache();
+
+  bool isEmpty() const;
+  void clear();
+  // NOTE: Never blocks; cf. loadAsync().
+  bool contains(const int page) const;
+  // NOTE: Loads the page's words & rectangles on csPDFium::textThreadPool();
+  //       the result is 'page', unless it failed to load.
+  QFuture<int> loadAsync(const int page) const;
+  int maxPages() const;
+  void setMaxPages(const int max);
+  QStringList words(const int page) const;
+  // NOTE: The hit's words & up to 'width' words on either side.
+  QStringList context(const csPdfSearchResult& result, const int width) const;
+  QString contextString(const csPdfSearchResult& result, const int width) const;
+  // NOTE: The hit's word rectangles in page coordinates; cf. csPDFiumText::rect().
+  QList<QRectF> rects(const csPdfSearchResult& result) const;
+
+private:
+  bool lookup(const int page, const bool withRects,
+              csPdfSearchPageText *text) const;
+
+  QSharedPointer<csPdfSearchTextCacheImpl> impl;
+
+  friend class csPdfSearchTextTask;
+};
+
+#endif // CSPDFSEARCHTEXTCACHE_H
@@ -33,12 +33,18 @@
 #define CSPDFSEARCHUTIL_H
 
 #include <QList>
+#include <QPair>
+#include <QRegularExpression>
 
 #include <csPDFSearch/cspdfsearch_config.h>
 #include <csPDFium/csPDFiumText.h>
+#include <csPDFSearch/csPdfMatcher.h>
 
 typedef QList<int> csPdfFindResults;
 
+typedef QPair<int,int>        csPdfFindSpan; // (Word, Number of Words)
+typedef QList<csPdfFindSpan> csPdfFindSpans;
+
 CS_PDFSEARCH_EXPORT int csPdfFind(const csPDFiumTexts& hay,
                                   const QString& needle,
                                   const int position = 0,
@@ -57,6 +63,25 @@ CS_PDFSEARCH_EXPORT csPdfFindResults csPdfFindAll(const csPDFiumTexts& hay,
                                                   const QStringList& needles,
                                                   const Qt::CaseSensitivity cs = Qt::CaseSensitive);
 
+// NOTE: Needles & text MUST share the case sensitivity; one needle matches
+//       within a word, several needles match a phrase, cf. above.
+CS_PDFSEARCH_EXPORT int csPdfFind(const csPdfMatchText& hay,
+                                  const csPdfMatchers& needles,
+                                  const int position = 0);
+
+CS_PDFSEARCH_EXPORT csPdfFindResults csPdfFindAll(const csPdfMatchText& hay,
+                                                  const csPdfMatchers& needles);
+
+// NOTE: One pass over the text; a match is mapped to the words it touches.
+//       At most one match is reported per starting word.
+CS_PDFSEARCH_EXPORT csPdfFindSpans csPdfFindAll(const csPdfMatchText& hay,
+                                                const QRegularExpression& regexp);
+
+// NOTE: Verifies a match at 'index'; e.g. to narrow down earlier results.
+CS_PDFSEARCH_EXPORT bool csPdfMatchAt(const csPdfMatchText& hay,
+                                      const csPdfMatchers& needles,
+                                      const int index);
+
 CS_PDFSEARCH_EXPORT QStringList csPdfPrepareSearch(const QString& text);
 
 #endif // CSPDFSEARCHUTIL_H
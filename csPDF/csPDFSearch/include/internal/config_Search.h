@@ -34,4 +34,6 @@
 
 #define CSPDF_SEARCH_BLOCKSIZE  5
 
+#define CSPDF_SEARCH_TEXTCACHE_PAGES  64
+
 #endif // CONFIG_SEARCH_H
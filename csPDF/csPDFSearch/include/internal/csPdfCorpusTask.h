@@ -0,0 +1,241 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFCORPUSTASK_H
+#define CSPDFCORPUSTASK_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+#include <csPDFium/csPDFiumDocument.h>
+
+#include <csPDFSearch/csPdfCorpusIndex.h>
+#include <csPDFSearch/csPdfSearchIndex.h>
+
+////// Job ///////////////////////////////////////////////////////////////////
+
+class csPdfCorpusJob {
+public:
+  csPdfCorpusJob(const QStringList& _files, const QString& _dir,
+                 const int numWorkers)
+    : files(_files)
+    , dir(_dir)
+    , next(0)
+    , done(0)
+    , workers(numWorkers)
+    , result()
+  {
+    result.reportStarted();
+    result.setProgressRange(0, files.size());
+    result.setProgressValue(0);
+  }
+
+  ~csPdfCorpusJob()
+  {
+  }
+
+  QStringList files;
+  QString dir;
+  QAtomicInt next;    // Next file to claim
+  QAtomicInt done;    // Files indexed
+  QAtomicInt workers; // Still running
+  QFutureInterface<csPdfCorpusEntry> result;
+
+private:
+  Q_DISABLE_COPY(csPdfCorpusJob)
+};
+
+typedef QSharedPointer<csPdfCorpusJob> csPdfCorpusJobPtr;
+
+////// Worker ////////////////////////////////////////////////////////////////
+
+// NOTE: One document per worker at a time; results are indexed by file.
+//       Loading & indexing only use csPDFium's API, whose PDFium calls are
+//       serialized library-wide, i.e. workers overlap hashing, file I/O and
+//       building the shards' postings.
+class csPdfCorpusTask : public QRunnable {
+public:
+  csPdfCorpusTask(const csPdfCorpusJobPtr& job)
+    : _job(job)
+  {
+    setAutoDelete(true);
+  }
+
+  ~csPdfCorpusTask()
+  {
+  }
+
+  void run()
+  {
+    while( !_job->result.isCanceled() ) {
+      const int i = _job->next.fetchAndAddRelaxed(1);
+      if( i >= _job->files.size() ) {
+        break;
+      }
+
+      _job->result.reportResult(indexFile(_job->files[i], _job->dir), i);
+      _job->result.setProgressValue(_job->done.fetchAndAddOrdered(1)+1);
+    }
+
+    if( !_job->workers.deref() ) {
+      _job->result.reportFinished();
+    }
+  }
+
+private:
+  Q_DISABLE_COPY(csPdfCorpusTask)
+
+  static csPdfCorpusEntry indexFile(const QString& filename, const QString& dir)
+  {
+    const QFileInfo info(filename);
+
+    csPdfCorpusEntry entry;
+    entry.fileName = filename;
+    entry.size     = info.size();
+    entry.modified = info.lastModified();
+    entry.key      = csPdfSearchIndex::documentKey(filename);
+    if( entry.key.isEmpty() ) {
+      return entry;
+    }
+
+    // (1) Shard Exists, e.g. for a Copy or a Renamed File ///////////////////
+
+    const csPdfSearchIndex shard =
+        csPdfSearchIndex::open(csPdfSearchIndex::indexFileName(dir, entry.key),
+                               entry.key);
+    if( !shard.isEmpty() ) {
+      entry.pageCount = shard.pageCount();
+      return entry;
+    }
+
+    // (2) New Shard /////////////////////////////////////////////////////////
+
+    const csPDFiumDocument doc = csPDFiumDocument::load(filename);
+    if( !doc.isEmpty()  &&  csPdfSearchIndex::build(doc, dir) ) {
+      entry.pageCount = doc.pageCount();
+    }
+
+    return entry;
+  }
+
+  csPdfCorpusJobPtr _job;
+};
+
+////// Find Job //////////////////////////////////////////////////////////////
+
+class csPdfCorpusFindJob {
+public:
+  csPdfCorpusFindJob(const csPdfCorpusEntries& _entries, const QString& _dir,
+                     const QStringList& _needles, const Qt::CaseSensitivity _cs,
+                     const int numWorkers)
+    : entries(_entries)
+    , dir(_dir)
+    , needles(_needles)
+    , cs(_cs)
+    , next(0)
+    , done(0)
+    , workers(numWorkers)
+    , result()
+  {
+    result.reportStarted();
+    result.setProgressRange(0, entries.size());
+    result.setProgressValue(0);
+  }
+
+  ~csPdfCorpusFindJob()
+  {
+  }
+
+  csPdfCorpusEntries entries;
+  QString dir;
+  QStringList needles;
+  Qt::CaseSensitivity cs;
+  QAtomicInt next;    // Next entry to claim
+  QAtomicInt done;    // Entries searched
+  QAtomicInt workers; // Still running
+  QFutureInterface<csPdfCorpusResult> result;
+
+private:
+  Q_DISABLE_COPY(csPdfCorpusFindJob)
+};
+
+typedef QSharedPointer<csPdfCorpusFindJob> csPdfCorpusFindJobPtr;
+
+////// Find Worker ///////////////////////////////////////////////////////////
+
+// NOTE: A shard is opened, searched & closed again, i.e. a worker holds at
+//       most one file handle & mapping at a time.
+class csPdfCorpusFindTask : public QRunnable {
+public:
+  csPdfCorpusFindTask(const csPdfCorpusFindJobPtr& job)
+    : _job(job)
+  {
+    setAutoDelete(true);
+  }
+
+  ~csPdfCorpusFindTask()
+  {
+  }
+
+  void run()
+  {
+    while( !_job->result.isCanceled() ) {
+      const int i = _job->next.fetchAndAddRelaxed(1);
+      if( i >= _job->entries.size() ) {
+        break;
+      }
+
+      const csPdfCorpusEntry& entry = _job->entries[i];
+      const csPdfSearchResults hits =
+          csPdfSearchIndex::open(csPdfSearchIndex::indexFileName(_job->dir, entry.key),
+                                 entry.key).find(_job->needles, _job->cs);
+      if( !hits.isEmpty() ) {
+        _job->result.reportResult(csPdfCorpusResult(entry.fileName, hits));
+      }
+      _job->result.setProgressValue(_job->done.fetchAndAddOrdered(1)+1);
+    }
+
+    if( !_job->workers.deref() ) {
+      _job->result.reportFinished();
+    }
+  }
+
+private:
+  Q_DISABLE_COPY(csPdfCorpusFindTask)
+
+  csPdfCorpusFindJobPtr _job;
+};
+
+#endif // CSPDFCORPUSTASK_H
@@ -0,0 +1,215 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFQUICKSEARCHTASK_H
+#define CSPDFQUICKSEARCHTASK_H
+
+#include <QtCore/QFutureInterface>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QRectF>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+#include <csPDFium/csPDFiumDocument.h>
+#include <csPDFium/csPDFiumTextPage.h>
+
+#include <csPDFSearch/csPdfMatcher.h>
+#include <csPDFSearch/csPdfSearchResult.h>
+#include <csPDFSearch/csPdfSearchUtil.h>
+
+////// Hits //////////////////////////////////////////////////////////////////
+
+// NOTE: The hits' word rectangles in page coordinates; cf. csPDFiumText::rect().
+struct csPdfQuickSearchHits {
+  csPdfSearchResults results;
+  QList<QRectF> rects;
+};
+
+////// State /////////////////////////////////////////////////////////////////
+
+// NOTE: The prepared text of the last page searched & the last query's hits
+//       on it; a query extending the last query narrows down its hits.
+class csPdfQuickSearchState {
+public:
+  csPdfQuickSearchState()
+    : mutex()
+    , pageNo(-1)
+    , cs(Qt::CaseSensitive)
+    , text()
+    , rects()
+    , query()
+    , hits()
+  {
+  }
+
+  ~csPdfQuickSearchState()
+  {
+  }
+
+  QMutex mutex;
+  int pageNo;
+  Qt::CaseSensitivity cs;
+  QSharedPointer<csPdfMatchText> text;
+  QList<QRectF> rects; // Of the page's words
+  QString query;
+  csPdfFindResults hits;
+
+private:
+  Q_DISABLE_COPY(csPdfQuickSearchState)
+};
+
+typedef QSharedPointer<csPdfQuickSearchState> csPdfQuickSearchStatePtr;
+
+////// Worker ////////////////////////////////////////////////////////////////
+
+class csPdfQuickSearchTask : public QRunnable {
+public:
+  csPdfQuickSearchTask(const csPdfQuickSearchStatePtr& state,
+                       const csPDFiumDocument& doc, const int pageNo,
+                       const QString& query, const Qt::CaseSensitivity cs)
+    : _state(state)
+    , _doc(doc)
+    , _pageNo(pageNo)
+    , _query(query)
+    , _cs(cs)
+    , _result()
+  {
+    setAutoDelete(true);
+    _result.reportStarted();
+  }
+
+  ~csPdfQuickSearchTask()
+  {
+  }
+
+  QFuture<csPdfQuickSearchHits> future()
+  {
+    return _result.future();
+  }
+
+  void run()
+  {
+    if( !_result.isCanceled() ) {
+      _result.reportResult(search());
+    }
+    _result.reportFinished();
+  }
+
+private:
+  Q_DISABLE_COPY(csPdfQuickSearchTask)
+
+  csPdfQuickSearchHits search()
+  {
+    const QStringList needles = csPdfPrepareSearch(_query);
+    if( needles.isEmpty() ) {
+      return csPdfQuickSearchHits();
+    }
+
+    // (1) Prepared Text of Page /////////////////////////////////////////////
+
+    QSharedPointer<csPdfMatchText> text;
+    QList<QRectF> rects;
+    QString lastQuery;
+    csPdfFindResults lastHits;
+    {
+      QMutexLocker locker(&_state->mutex);
+      if( _state->pageNo == _pageNo  &&  _state->cs == _cs ) {
+        text      = _state->text;
+        rects     = _state->rects;
+        lastQuery = _state->query;
+        lastHits  = _state->hits;
+      }
+    }
+
+    if( text.isNull() ) {
+      const csPDFiumTexts texts = _doc.textPage(_pageNo).texts();
+      text = QSharedPointer<csPdfMatchText>(new csPdfMatchText(texts, _cs));
+      rects.clear();
+      foreach(const csPDFiumText& t, texts) {
+        rects.push_back(t.rect());
+      }
+      if( _result.isCanceled() ) {
+        return csPdfQuickSearchHits();
+      }
+    }
+
+    // (2) Narrow Down or Search /////////////////////////////////////////////
+
+    const csPdfMatchers matchers = csPdfCompileMatchers(needles, _cs);
+
+    // NOTE: Extending a query only ever removes hits; cf. csPdfFindAll().
+    csPdfFindResults hits;
+    if( !lastQuery.isEmpty()  &&  _query.startsWith(lastQuery) ) {
+      foreach(const int index, lastHits) {
+        if( csPdfMatchAt(*text, matchers, index) ) {
+          hits.push_back(index);
+        }
+      }
+    } else {
+      hits = csPdfFindAll(*text, matchers);
+    }
+
+    {
+      QMutexLocker locker(&_state->mutex);
+      _state->pageNo = _pageNo;
+      _state->cs     = _cs;
+      _state->text   = text;
+      _state->rects  = rects;
+      _state->query  = _query;
+      _state->hits   = hits;
+    }
+
+    // (3) Results ///////////////////////////////////////////////////////////
+
+    // NOTE: The rectangles spare the GUI thread loading the page's text.
+    csPdfQuickSearchHits result;
+    result.results.reserve(hits.size());
+    foreach(const int index, hits) {
+      result.results.push_back(csPdfSearchResult(_pageNo, index, needles.size()));
+      for(int i = index; i < index+needles.size()  &&  i < rects.size(); i++) {
+        result.rects.push_back(rects[i]);
+      }
+    }
+
+    return result;
+  }
+
+  csPdfQuickSearchStatePtr _state;
+  csPDFiumDocument _doc;
+  int _pageNo;
+  QString _query;
+  Qt::CaseSensitivity _cs;
+  QFutureInterface<csPdfQuickSearchHits> _result;
+};
+
+#endif // CSPDFQUICKSEARCHTASK_H
@@ -0,0 +1,170 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFSEARCHINDEXIMPL_H
+#define CSPDFSEARCHINDEXIMPL_H
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <csPDFium/csPDFiumTextPage.h>
+#include <csPDFSearch/cspdfsearch_config.h>
+
+#define CSPDF_INDEX_MAGIC    0x49505343 // "CSPI"
+#define CSPDF_INDEX_VERSION  1
+#define CSPDF_INDEX_KEYSIZE  20         // SHA-1
+#define CSPDF_INDEX_SUFFIX   ".cspi"
+
+////// File Format ///////////////////////////////////////////////////////////
+
+// NOTE: Native byte order; a foreign byte order fails the magic check.
+//       All sections are 4-byte aligned; offsets are relative to the file.
+struct csPdfIndexHeader {
+  quint32 magic;
+  quint32 version;
+  quint32 pageCount;
+  quint32 termCount;
+  quint32 postingCount;
+  quint32 wordCount;   // Sum of all pages' words
+  quint32 charCount;   // Size of the term pool
+  quint32 termsOffset;
+  quint32 postingsOffset;
+  quint32 pagesOffset;
+  quint32 wordsOffset;
+  quint32 charsOffset;
+  char key[CSPDF_INDEX_KEYSIZE];
+};
+
+// Sorted by text; cf. QString::operator<()
+struct csPdfIndexTerm {
+  quint32 charOffset;
+  quint32 length;
+  quint32 firstPosting;
+  quint32 numPostings;
+};
+
+// Sorted by page, then index
+struct csPdfIndexPosting {
+  quint32 page;
+  quint32 index; // Into csPDFiumTextPage::texts()
+};
+
+// Pages: pageCount+1 Offsets into Words
+// Words: wordCount Term IDs, i.e. each page's words in reading order
+
+////// Mapped Index //////////////////////////////////////////////////////////
+
+class csPdfSearchIndexImpl {
+public:
+  csPdfSearchIndexImpl()
+    : file()
+    , data(nullptr)
+    , header(nullptr)
+    , terms(nullptr)
+    , postings(nullptr)
+    , pages(nullptr)
+    , words(nullptr)
+    , chars(nullptr)
+  {
+  }
+
+  ~csPdfSearchIndexImpl()
+  {
+    if( data != nullptr ) {
+      file.unmap(const_cast<uchar*>(data));
+    }
+  }
+
+  // NOTE: References the mapping; cf. text() for a deep copy.
+  inline QString term(const quint32 id) const
+  {
+    return QString::fromRawData(reinterpret_cast<const QChar*>(chars + terms[id].charOffset),
+                                terms[id].length);
+  }
+
+  inline QString text(const quint32 id) const
+  {
+    return QString(reinterpret_cast<const QChar*>(chars + terms[id].charOffset),
+                   terms[id].length);
+  }
+
+  inline int wordCount(const int page) const
+  {
+    return pages[page+1] - pages[page];
+  }
+
+  inline quint32 wordAt(const int page, const int index) const
+  {
+    return words[pages[page] + index];
+  }
+
+  bool map(const QString& filename);
+
+  QFile file;
+  const uchar *data;
+  const csPdfIndexHeader  *header;
+  const csPdfIndexTerm    *terms;
+  const csPdfIndexPosting *postings;
+  const quint32           *pages;
+  const quint32           *words;
+  const ushort            *chars;
+
+private:
+  Q_DISABLE_COPY(csPdfSearchIndexImpl)
+};
+
+////// Builder ///////////////////////////////////////////////////////////////
+
+// NOTE: Pages may be added in any order; memory is 4 bytes per word plus
+//       the vocabulary. Exported for the tests.
+class CS_PDFSEARCH_EXPORT csPdfSearchIndexBuilder {
+public:
+  csPdfSearchIndexBuilder(const int pageCount = 0);
+  ~csPdfSearchIndexBuilder();
+
+  bool isComplete() const;
+  void addPage(const csPDFiumTextPage& page);
+  void addPage(const int no, const csPDFiumTexts& texts);
+  bool write(const QString& filename, const QByteArray& key) const;
+
+private:
+  quint32 termId(const QString& word);
+
+  QHash<QString,quint32> _ids;
+  QStringList _terms;
+  QVector<QVector<quint32> > _pages;
+  QVector<bool> _added;
+  int _numAdded;
+};
+
+#endif // CSPDFSEARCHINDEXIMPL_H
@@ -0,0 +1,254 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFSEARCHTASK_H
+#define CSPDFSEARCHTASK_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QMutex>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QRunnable>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+
+#include <csPDFium/csPDFiumDocument.h>
+
+#include <csPDFSearch/csPdfMatcher.h>
+#include <csPDFSearch/csPdfSearch.h>
+#include <csPDFSearch/csPdfSearchIndex.h>
+#include <csPDFSearch/csPdfSearchResult.h>
+
+#include "internal/config_Search.h"
+#include "internal/csPdfSearchIndexImpl.h"
+
+////// Job ///////////////////////////////////////////////////////////////////
+
+// NOTE: Pages are visited in search order, i.e. starting at 'start' & wrapping
+//       around; the order is cut into blocks of CSPDF_SEARCH_BLOCKSIZE pages.
+class csPdfSearchJob {
+public:
+  csPdfSearchJob(const csPDFiumDocument& _doc, const QStringList& _needles,
+                 const QStringList& _patterns, const QRegularExpression& _regexp,
+                 const Qt::CaseSensitivity _cs,
+                 const int _start, const int _numPages,
+                 volatile bool *_cancel,
+                 const csPdfSearchIndex& _index,
+                 csPdfSearchIndexBuilder *_builder,
+                 const int numWorkers)
+    : doc(_doc)
+    , needles(csPdfCompileMatchers(_needles, _cs))
+    , patterns(_patterns, _cs)
+    , regexp(_regexp)
+    , cs(_cs)
+    , start(_start)
+    , numPages(_numPages)
+    , numBlocks((_numPages + CSPDF_SEARCH_BLOCKSIZE-1) / CSPDF_SEARCH_BLOCKSIZE)
+    , cancel(_cancel)
+    , index(_index)
+    , builder(_builder)
+    , builderMutex()
+    , next(0)
+    , done(0)
+    , workers(numWorkers)
+    , result()
+  {
+    result.reportStarted();
+    result.setProgressRange(0, numPages);
+    result.setProgressValue(0);
+  }
+
+  ~csPdfSearchJob()
+  {
+  }
+
+  inline int pageAt(const int i) const
+  {
+    return (start + i) % doc.pageCount();
+  }
+
+  csPDFiumDocument doc;
+  csPdfMatchers needles; // Compiled once per search
+  csPdfMultiMatcher patterns; // Ditto; replaces 'needles' unless empty
+  QRegularExpression regexp;  // Ditto; replaces both unless empty
+  Qt::CaseSensitivity cs;
+  int start;
+  int numPages;   // To search
+  int numBlocks;
+  volatile bool *cancel;
+  csPdfSearchIndex index; // Optional; its words replace text extraction
+  csPdfSearchIndexBuilder *builder; // Optional
+  QMutex builderMutex;
+  QAtomicInt next;    // Next block to claim
+  QAtomicInt done;    // Pages searched
+  QAtomicInt workers; // Still running
+  QFutureInterface<csPdfSearchResults> result;
+
+private:
+  Q_DISABLE_COPY(csPdfSearchJob)
+};
+
+typedef QSharedPointer<csPdfSearchJob> csPdfSearchJobPtr;
+
+////// Worker ////////////////////////////////////////////////////////////////
+
+// NOTE: Idle workers claim the next block in search order; hence the blocks
+//       nearest to the start are always served first. A block's pages are
+//       extracted under the document's lock, then matched without it; given
+//       an index, its words are matched instead.
+class csPdfSearchTask : public QRunnable {
+public:
+  csPdfSearchTask(const csPdfSearchJobPtr& job)
+    : _job(job)
+  {
+    setAutoDelete(true);
+  }
+
+  ~csPdfSearchTask()
+  {
+  }
+
+  void run()
+  {
+    // NOTE: QRegularExpression is reentrant only, and a copy would share its
+    //       compiled pattern; hence every worker compiles its own instance.
+    const QRegularExpression regexp(_job->regexp.pattern(),
+                                    _job->regexp.patternOptions());
+    regexp.optimize();
+
+    // NOTE: Case is handled by the expression; the text is kept as is.
+    const Qt::CaseSensitivity cs = regexp.pattern().isEmpty()
+        ? _job->cs
+        : Qt::CaseSensitive;
+
+    while( !*_job->cancel ) {
+      const int block = _job->next.fetchAndAddRelaxed(1);
+      if( block >= _job->numBlocks ) {
+        break;
+      }
+
+      const int first = block*CSPDF_SEARCH_BLOCKSIZE;
+      const int last  = qMin(first+CSPDF_SEARCH_BLOCKSIZE, _job->numPages);
+
+      csPdfSearchPages pages;
+      if( !_job->index.isEmpty() ) {
+        for(int i = first; i < last; i++) {
+          const int no = _job->pageAt(i);
+          pages.push_back(csPdfSearchPage(no, csPdfMatchText(_job->index.words(no), cs)));
+        }
+      } else {
+        csPDFiumTextPages textPages;
+        for(int i = first; i < last; i++) {
+          textPages += _job->doc.textPages(_job->pageAt(i), 1);
+        }
+
+        if( _job->builder != nullptr ) {
+          QMutexLocker locker(&_job->builderMutex);
+          foreach(const csPDFiumTextPage& page, textPages) {
+            _job->builder->addPage(page);
+          }
+        }
+
+        foreach(const csPDFiumTextPage& page, textPages) {
+          pages.push_back(csPdfSearchPage(page.pageNo(), csPdfMatchText(page.texts(), cs)));
+        }
+      }
+
+      // NOTE: Every block reports, even without hits; cf. csPdfSearch::storeResults().
+      csPdfSearchResults results;
+      if(        !regexp.pattern().isEmpty() ) {
+        results = csPdfSearch::searchPages(pages, regexp);
+      } else if( !_job->patterns.isEmpty() ) {
+        results = csPdfSearch::searchPages(pages, _job->patterns);
+      } else {
+        results = csPdfSearch::searchPages(pages, _job->needles);
+      }
+      _job->result.reportResult(results, block);
+      _job->result.setProgressValue(_job->done.fetchAndAddOrdered(last-first)+last-first);
+    }
+
+    if( !_job->workers.deref() ) {
+      _job->result.reportFinished();
+    }
+  }
+
+private:
+  Q_DISABLE_COPY(csPdfSearchTask)
+
+  csPdfSearchJobPtr _job;
+};
+
+////// Index /////////////////////////////////////////////////////////////////
+
+// NOTE: Hashes the document; 'current' is reused if it is the document's.
+class csPdfSearchOpenTask : public QRunnable {
+public:
+  csPdfSearchOpenTask(const csPDFiumDocument& doc, const QString& dir,
+                      const csPdfSearchIndex& current)
+    : _doc(doc)
+    , _dir(dir)
+    , _current(current)
+    , _result()
+  {
+    setAutoDelete(true);
+    _result.reportStarted();
+  }
+
+  ~csPdfSearchOpenTask()
+  {
+  }
+
+  inline QFuture<csPdfSearchIndex> future()
+  {
+    return _result.future();
+  }
+
+  void run()
+  {
+    if( !_current.isEmpty()  &&
+        _current.key() == csPdfSearchIndex::documentKey(_doc.fileName()) ) {
+      _result.reportResult(_current);
+    } else {
+      _result.reportResult(csPdfSearchIndex::open(_doc, _dir));
+    }
+    _result.reportFinished();
+  }
+
+private:
+  Q_DISABLE_COPY(csPdfSearchOpenTask)
+
+  csPDFiumDocument _doc;
+  QString _dir;
+  csPdfSearchIndex _current;
+  QFutureInterface<csPdfSearchIndex> _result;
+};
+
+#endif // CSPDFSEARCHTASK_H
@@ -0,0 +1,74 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFSEARCHTEXTCACHEIMPL_H
+#define CSPDFSEARCHTEXTCACHEIMPL_H
+
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QRectF>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include <csPDFium/csPDFiumDocument.h>
+
+#include <csPDFSearch/csPdfSearchIndex.h>
+
+#include "internal/config_Search.h"
+
+// NOTE: Words looked up in the index come without their rectangles.
+struct csPdfSearchPageText {
+  QStringList words;
+  QVector<QRectF> rects;
+};
+
+class csPdfSearchTextCacheImpl {
+public:
+  csPdfSearchTextCacheImpl(const csPDFiumDocument& _doc,
+                           const csPdfSearchIndex& _index)
+    : doc(_doc)
+    , index(_index)
+    , mutex()
+    , pages(CSPDF_SEARCH_TEXTCACHE_PAGES)
+  {
+  }
+
+  ~csPdfSearchTextCacheImpl()
+  {
+  }
+
+  csPDFiumDocument doc;
+  csPdfSearchIndex index; // Optional
+  QMutex mutex;
+  QCache<int,csPdfSearchPageText> pages; // By Page
+};
+
+#endif // CSPDFSEARCHTEXTCACHEIMPL_H
@@ -0,0 +1,85 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFSEARCHTEXTTASK_H
+#define CSPDFSEARCHTEXTTASK_H
+
+#include <QtCore/QFuture>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QRunnable>
+
+#include <csPDFSearch/csPdfSearchTextCache.h>
+
+#include "internal/csPdfSearchTextCacheImpl.h"
+
+// NOTE: Loads a page's words & rectangles into the cache; the result is
+//       the page's number.
+class csPdfSearchTextTask : public QRunnable {
+public:
+  csPdfSearchTextTask(const csPdfSearchTextCache& cache, const int page)
+    : _cache(cache)
+    , _page(page)
+    , _result()
+  {
+    setAutoDelete(true);
+    _result.reportStarted();
+  }
+
+  ~csPdfSearchTextTask()
+  {
+  }
+
+  inline QFuture<int> future()
+  {
+    return _result.future();
+  }
+
+  void run()
+  {
+    // NOTE: Canceled requests still waiting in the queue are skipped!
+    if( !_result.isCanceled() ) {
+      csPdfSearchPageText text;
+      if( _cache.lookup(_page, true, &text) ) {
+        _result.reportResult(_page);
+      }
+    }
+    _result.reportFinished();
+  }
+
+private:
+  Q_DISABLE_COPY(csPdfSearchTextTask)
+
+  csPdfSearchTextCache _cache;
+  int _page;
+  QFutureInterface<int> _result;
+};
+
+#endif // CSPDFSEARCHTEXTTASK_H
@@ -0,0 +1,131 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef MATCH_UTIL_H
+#define MATCH_UTIL_H
+
+#include <cstring>
+
+#if defined(__SSE2__)  ||  defined(_M_X64)  ||  (defined(_M_IX86_FP)  &&  _M_IX86_FP >= 2)
+# define CSPDF_MATCH_SSE2
+# include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
+
+// NOTE: Needles of at least this length are matched by Horspool's algorithm;
+//       shorter ones by a (SIMD) scan for their first character.
+#define CSPDF_HORSPOOL_MIN  4
+#define CSPDF_HORSPOOL_SIZE 256 // Skip Table; indexed by the low byte
+
+namespace util {
+
+  typedef unsigned short char16;
+
+  inline int countTrailingZeros(const unsigned int x)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return int(index);
+#else
+    return __builtin_ctz(x);
+#endif
+  }
+
+  // Position of 'c' in [from, end); -1 if not found.
+  inline int findChar(const char16 *hay, const int end, int from, const char16 c)
+  {
+#ifdef CSPDF_MATCH_SSE2
+    const __m128i needle = _mm_set1_epi16(short(c));
+    for(; from+8 <= end; from += 8) {
+      const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + from));
+      const int mask  = _mm_movemask_epi8(_mm_cmpeq_epi16(v, needle));
+      if( mask != 0 ) {
+        return from + countTrailingZeros(unsigned(mask))/2;
+      }
+    }
+#endif
+    for(; from < end; from++) {
+      if( hay[from] == c ) {
+        return from;
+      }
+    }
+    return -1;
+  }
+
+  inline int findShort(const char16 *hay, const int size, int from,
+                       const char16 *needle, const int length)
+  {
+    const int end = size-length+1; // Last Start + 1
+    while( from < end ) {
+      from = findChar(hay, end, from, needle[0]);
+      if( from < 0 ) {
+        return -1;
+      }
+      if( std::memcmp(hay+from+1, needle+1, (length-1)*sizeof(char16)) == 0 ) {
+        return from;
+      }
+      from++;
+    }
+    return -1;
+  }
+
+  inline void initHorspool(int *skip, const char16 *needle, const int length)
+  {
+    for(int i = 0; i < CSPDF_HORSPOOL_SIZE; i++) {
+      skip[i] = length;
+    }
+    for(int i = 0; i < length-1; i++) {
+      skip[needle[i] & 0xFF] = length-1-i;
+    }
+  }
+
+  inline int findHorspool(const char16 *hay, const int size, int from,
+                          const char16 *needle, const int length, const int *skip)
+  {
+    const char16 last = needle[length-1];
+    while( from <= size-length ) {
+      const char16 c = hay[from+length-1];
+      if( c == last  &&
+          std::memcmp(hay+from, needle, (length-1)*sizeof(char16)) == 0 ) {
+        return from;
+      }
+      from += skip[c & 0xFF];
+    }
+    return -1;
+  }
+
+} // namespace util
+
+#endif // MATCH_UTIL_H
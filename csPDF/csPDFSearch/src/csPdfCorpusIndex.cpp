@@ -0,0 +1,433 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QSaveFile>
+#include <QSet>
+#include <QThreadPool>
+
+#include <csPDFium/csPDFium.h>
+#include <csPDFium/csPDFiumUtil.h>
+
+#include <csPDFSearch/csPdfCorpusIndex.h>
+
+#include "internal/csPdfCorpusTask.h"
+
+#define CSPDF_MANIFEST_MAGIC    0x4D505343 // "CSPM"
+#define CSPDF_MANIFEST_VERSION  1
+#define CSPDF_MANIFEST_SUFFIX   ".manifest"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  struct ResultLess {
+    inline bool operator()(const csPdfCorpusResult& a, const csPdfCorpusResult& b) const
+    {
+      return a.first < b.first;
+    }
+  };
+
+  // NOTE: Any manifest, i.e. of any root directory.
+  static bool readManifest(const QString& filename,
+                           QString *root, csPdfCorpusEntries *entries)
+  {
+    QFile file(filename);
+    if( !file.open(QIODevice::ReadOnly) ) {
+      return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_6);
+
+    quint32 magic(0), version(0);
+    qint32 count(0);
+    stream >> magic >> version >> *root >> count;
+    if( magic != CSPDF_MANIFEST_MAGIC  ||  version != CSPDF_MANIFEST_VERSION  ||
+        count < 0 ) {
+      return false;
+    }
+
+    for(qint32 i = 0; i < count  &&  stream.status() == QDataStream::Ok; i++) {
+      csPdfCorpusEntry entry;
+      qint32 pageCount(-1);
+      stream >> entry.fileName >> entry.size >> entry.modified >> entry.key >> pageCount;
+      entry.pageCount = pageCount;
+      entries->push_back(entry);
+    }
+
+    return stream.status() == QDataStream::Ok;
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPdfCorpusIndex::csPdfCorpusIndex(const QString& rootDir, const QString& indexDir,
+                                   QObject *parent)
+  : QObject(parent)
+  , _rootDir(QDir(rootDir).canonicalPath())
+  , _indexDir(indexDir)
+  , _entries()
+  , _watcher(nullptr)
+  , _shards(CSPDF_CORPUS_SHARDS)
+  , _stale()
+  , _lastProgress(-1)
+{
+  _watcher = new QFutureWatcher<csPdfCorpusEntry>(this);
+
+  connect(_watcher, &QFutureWatcher<csPdfCorpusEntry>::finished,
+          this, &csPdfCorpusIndex::finishUpdate);
+  connect(_watcher, &QFutureWatcher<csPdfCorpusEntry>::progressValueChanged,
+          this, &csPdfCorpusIndex::progressUpdate);
+  connect(_watcher, &QFutureWatcher<csPdfCorpusEntry>::resultReadyAt,
+          this, &csPdfCorpusIndex::storeEntry);
+
+  loadManifest();
+}
+
+csPdfCorpusIndex::~csPdfCorpusIndex()
+{
+  if( isRunning() ) {
+    _watcher->cancel();
+    _watcher->waitForFinished();
+  }
+}
+
+bool csPdfCorpusIndex::isRunning() const
+{
+  return _watcher->isRunning();
+}
+
+QString csPdfCorpusIndex::rootDirectory() const
+{
+  return _rootDir;
+}
+
+QString csPdfCorpusIndex::indexDirectory() const
+{
+  return _indexDir;
+}
+
+csPdfCorpusEntries csPdfCorpusIndex::entries() const
+{
+  return _entries.values();
+}
+
+QStringList csPdfCorpusIndex::fileNames() const
+{
+  QStringList files;
+  foreach(const csPdfCorpusEntry& entry, _entries) {
+    if( entry.isValid() ) {
+      files.push_back(entry.fileName);
+    }
+  }
+
+  return files;
+}
+
+bool csPdfCorpusIndex::update(const QStringList& nameFilters)
+{
+  if( isRunning()  ||  _rootDir.isEmpty()  ||
+      _indexDir.isEmpty()  ||  !QDir().mkpath(_indexDir) ) {
+    return false;
+  }
+
+  // (1) Crawl ///////////////////////////////////////////////////////////////
+
+  QSet<QString> found;
+  QStringList todo;
+
+  QDirIterator iter(_rootDir, nameFilters, QDir::Files | QDir::Readable,
+                    QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+  while( iter.hasNext() ) {
+    iter.next();
+    const QFileInfo info = iter.fileInfo();
+    const QString filename = info.canonicalFilePath();
+    if( filename.isEmpty()  ||  found.contains(filename) ) {
+      continue;
+    }
+    found.insert(filename);
+
+    if( !_entries.contains(filename)  ||  !_entries[filename].isCurrent(info) ) {
+      todo.push_back(filename);
+    }
+  }
+
+  // (2) Forget Removed Files; NOTE: Their shards may be shared! /////////////
+
+  QMap<QString,csPdfCorpusEntry>::iterator it = _entries.begin();
+  while( it != _entries.end() ) {
+    if( !found.contains(it.key()) ) {
+      _stale.insert(it.value().key);
+      it = _entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // (3) Index New & Changed Files ///////////////////////////////////////////
+
+  _lastProgress = -1;
+  emit started();
+
+  if( todo.isEmpty() ) {
+    saveManifest();
+    removeStaleShards();
+    emit processed(100);
+    emit finished();
+    return true;
+  }
+
+  QThreadPool *pool = csPDFium::textThreadPool();
+  const int numWorkers = qBound(1, todo.size(), qMax(1, pool->maxThreadCount()));
+
+  const csPdfCorpusJobPtr job(new csPdfCorpusJob(todo, _indexDir, numWorkers));
+  for(int i = 0; i < numWorkers; i++) {
+    pool->start(new csPdfCorpusTask(job));
+  }
+  _watcher->setFuture(job->result.future());
+
+  return true;
+}
+
+csPdfCorpusResults csPdfCorpusIndex::find(const QStringList& needles,
+                                          const Qt::CaseSensitivity cs) const
+{
+  QFuture<csPdfCorpusResult> future = findAsync(needles, cs);
+  future.waitForFinished();
+
+  csPdfCorpusResults results = future.results();
+  qSort(results.begin(), results.end(), priv::ResultLess());
+
+  return results;
+}
+
+QFuture<csPdfCorpusResult> csPdfCorpusIndex::findAsync(const QStringList& needles,
+                                                       const Qt::CaseSensitivity cs) const
+{
+  csPdfCorpusEntries entries;
+  foreach(const csPdfCorpusEntry& entry, _entries) {
+    if( entry.isValid() ) {
+      entries.push_back(entry);
+    }
+  }
+
+  if( entries.isEmpty()  ||  needles.isEmpty() ) {
+    QFutureInterface<csPdfCorpusResult> result;
+    result.reportStarted();
+    result.reportFinished();
+    return result.future();
+  }
+
+  QThreadPool *pool = csPDFium::textThreadPool();
+  const int numWorkers = qBound(1, entries.size(), qMax(1, pool->maxThreadCount()));
+
+  const csPdfCorpusFindJobPtr job(new csPdfCorpusFindJob(entries, _indexDir,
+                                                         needles, cs, numWorkers));
+  const QFuture<csPdfCorpusResult> future = job->result.future();
+  for(int i = 0; i < numWorkers; i++) {
+    pool->start(new csPdfCorpusFindTask(job));
+  }
+
+  return future;
+}
+
+csPdfSearchIndex csPdfCorpusIndex::index(const QString& filename) const
+{
+  return openShard(_entries.value(QFileInfo(filename).canonicalFilePath()));
+}
+
+////// public slots //////////////////////////////////////////////////////////
+
+void csPdfCorpusIndex::cancel()
+{
+  if( isRunning() ) {
+    _watcher->cancel();
+  }
+}
+
+////// private slots /////////////////////////////////////////////////////////
+
+void csPdfCorpusIndex::finishUpdate()
+{
+  // NOTE: Files indexed before a cancel are kept.
+  saveManifest();
+  removeStaleShards();
+
+  if( _watcher->isCanceled() ) {
+    emit canceled();
+  } else {
+    emit finished();
+  }
+}
+
+void csPdfCorpusIndex::progressUpdate(int value)
+{
+  const int max = _watcher->progressMaximum();
+  const int p   = max > 0
+      ? qBound(0, value * 100 / max, 100)
+      : 100;
+  if( p != _lastProgress ) {
+    emit processed(p);
+  }
+  _lastProgress = p;
+}
+
+void csPdfCorpusIndex::storeEntry(int index)
+{
+  const csPdfCorpusEntry entry = _watcher->resultAt(index);
+
+  // NOTE: A changed file gets a new key; drop the stale shard.
+  if( _entries.contains(entry.fileName)  &&
+      _entries[entry.fileName].key != entry.key ) {
+    _stale.insert(_entries[entry.fileName].key);
+  }
+  _entries.insert(entry.fileName, entry);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool csPdfCorpusIndex::loadManifest()
+{
+  _entries.clear();
+
+  QString root;
+  csPdfCorpusEntries entries;
+  if( !priv::readManifest(manifestFileName(), &root, &entries)  ||
+      root != _rootDir ) {
+    return false;
+  }
+
+  foreach(const csPdfCorpusEntry& entry, entries) {
+    _entries.insert(entry.fileName, entry);
+  }
+
+  return true;
+}
+
+QString csPdfCorpusIndex::manifestFileName() const
+{
+  if( _rootDir.isEmpty()  ||  _indexDir.isEmpty() ) {
+    return QString();
+  }
+
+  const QByteArray hash =
+      QCryptographicHash::hash(_rootDir.toUtf8(), QCryptographicHash::Sha1);
+
+  return QDir(_indexDir).filePath(QString::fromLatin1(hash.toHex()) +
+                                  _L1(CSPDF_MANIFEST_SUFFIX));
+}
+
+csPdfSearchIndex csPdfCorpusIndex::openShard(const csPdfCorpusEntry& entry) const
+{
+  if( !entry.isValid() ) {
+    return csPdfSearchIndex();
+  }
+
+  const csPdfSearchIndex *cached = _shards.object(entry.key);
+  if( cached != nullptr ) {
+    return *cached;
+  }
+
+  // NOTE: Evicting a shard closes its file, unless it is still referenced.
+  const csPdfSearchIndex shard =
+      csPdfSearchIndex::open(csPdfSearchIndex::indexFileName(_indexDir, entry.key),
+                             entry.key);
+  if( !shard.isEmpty() ) {
+    _shards.insert(entry.key, new csPdfSearchIndex(shard));
+  }
+
+  return shard;
+}
+
+void csPdfCorpusIndex::removeStaleShards()
+{
+  if( _stale.isEmpty() ) {
+    return;
+  }
+
+  // (1) Keys Still Referenced; NOTE: Shards are shared among all roots! /////
+
+  QSet<QByteArray> used;
+  foreach(const csPdfCorpusEntry& entry, _entries) {
+    used.insert(entry.key);
+  }
+
+  const QDir dir(_indexDir);
+  const QStringList manifests =
+      dir.entryList(QStringList(_L1("*" CSPDF_MANIFEST_SUFFIX)), QDir::Files);
+  foreach(const QString& name, manifests) {
+    QString root;
+    csPdfCorpusEntries entries;
+    if( !priv::readManifest(dir.filePath(name), &root, &entries) ) {
+      // CAUTION: An unreadable manifest might refer to any shard!
+      return;
+    }
+    foreach(const csPdfCorpusEntry& entry, entries) {
+      used.insert(entry.key);
+    }
+  }
+
+  // (2) Remove Unreferenced Shards //////////////////////////////////////////
+
+  foreach(const QByteArray& key, _stale) {
+    if( key.isEmpty()  ||  used.contains(key) ) {
+      continue;
+    }
+    _shards.remove(key);
+    QFile::remove(csPdfSearchIndex::indexFileName(_indexDir, key));
+  }
+  _stale.clear();
+}
+
+bool csPdfCorpusIndex::saveManifest() const
+{
+  QSaveFile file(manifestFileName());
+  if( !file.open(QIODevice::WriteOnly) ) {
+    return false;
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_6);
+
+  stream << quint32(CSPDF_MANIFEST_MAGIC) << quint32(CSPDF_MANIFEST_VERSION)
+         << _rootDir << qint32(_entries.size());
+  foreach(const csPdfCorpusEntry& entry, _entries) {
+    stream << entry.fileName << entry.size << entry.modified << entry.key
+           << qint32(entry.pageCount);
+  }
+
+  return stream.status() == QDataStream::Ok  &&  file.commit();
+}
@@ -0,0 +1,414 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include <QMap>
+#include <QStringList>
+
+#include <csPDFium/csPDFiumUtil.h>
+
+#include <csPDFSearch/csPdfMatcher.h>
+#include <csPDFSearch/csPdfSearchUtil.h>
+
+#include "internal/match_util.h"
+
+namespace priv {
+
+  static inline const util::char16 *utf16(const QChar *s)
+  {
+    return reinterpret_cast<const util::char16*>(s);
+  }
+
+} // namespace priv
+
+////// csPdfMatcher - public /////////////////////////////////////////////////
+
+csPdfMatcher::csPdfMatcher(const QString& needle, const Qt::CaseSensitivity cs)
+  : _pattern(prepare(needle, cs))
+  , _cs(cs)
+  , _skip()
+{
+  if( _pattern.size() >= CSPDF_HORSPOOL_MIN ) {
+    _skip.resize(CSPDF_HORSPOOL_SIZE);
+    util::initHorspool(_skip.data(), _pattern.utf16(), _pattern.size());
+  }
+}
+
+csPdfMatcher::~csPdfMatcher()
+{
+}
+
+bool csPdfMatcher::isEmpty() const
+{
+  return _pattern.isEmpty();
+}
+
+Qt::CaseSensitivity csPdfMatcher::caseSensitivity() const
+{
+  return _cs;
+}
+
+const QString& csPdfMatcher::pattern() const
+{
+  return _pattern;
+}
+
+int csPdfMatcher::size() const
+{
+  return _pattern.size();
+}
+
+int csPdfMatcher::indexIn(const QChar *hay, const int size, const int from) const
+{
+  if( isEmpty()  ||  from < 0  ||  size-from < _pattern.size() ) {
+    return -1;
+  }
+
+  return _skip.isEmpty()
+      ? util::findShort(priv::utf16(hay), size, from,
+                        _pattern.utf16(), _pattern.size())
+      : util::findHorspool(priv::utf16(hay), size, from,
+                           _pattern.utf16(), _pattern.size(), _skip.constData());
+}
+
+bool csPdfMatcher::equals(const QChar *s, const int size) const
+{
+  return size == _pattern.size()  &&
+      std::equal(s, s+size, _pattern.constData());
+}
+
+bool csPdfMatcher::isPrefixOf(const QChar *s, const int size) const
+{
+  return size >= _pattern.size()  &&
+      std::equal(_pattern.constData(), _pattern.constData()+_pattern.size(), s);
+}
+
+bool csPdfMatcher::isSuffixOf(const QChar *s, const int size) const
+{
+  return size >= _pattern.size()  &&
+      std::equal(_pattern.constData(), _pattern.constData()+_pattern.size(),
+                 s+size-_pattern.size());
+}
+
+QString csPdfMatcher::prepare(const QString& s, const Qt::CaseSensitivity cs)
+{
+  // NOTE: Simple case folding keeps the length; cf. QString::compare().
+  return cs == Qt::CaseInsensitive
+      ? s.toCaseFolded()
+      : s;
+}
+
+CS_PDFSEARCH_EXPORT csPdfMatchers csPdfCompileMatchers(const QStringList& needles,
+                                                       const Qt::CaseSensitivity cs)
+{
+  csPdfMatchers matchers;
+  foreach(const QString& needle, needles) {
+    matchers.push_back(csPdfMatcher(needle, cs));
+  }
+
+  return matchers;
+}
+
+////// csPdfMatchText - public ///////////////////////////////////////////////
+
+csPdfMatchText::csPdfMatchText(const csPDFiumTexts& texts, const Qt::CaseSensitivity cs)
+  : _cs(cs)
+  , _text()
+  , _starts()
+{
+  int size = 0;
+  foreach(const csPDFiumText& t, texts) {
+    size += t.text().size()+1;
+  }
+
+  _text.reserve(size);
+  _starts.reserve(texts.size()+1);
+  foreach(const csPDFiumText& t, texts) {
+    append(t.text());
+  }
+  _starts.push_back(_text.size());
+}
+
+csPdfMatchText::csPdfMatchText(const QStringList& words, const Qt::CaseSensitivity cs)
+  : _cs(cs)
+  , _text()
+  , _starts()
+{
+  int size = 0;
+  foreach(const QString& w, words) {
+    size += w.size()+1;
+  }
+
+  _text.reserve(size);
+  _starts.reserve(words.size()+1);
+  foreach(const QString& w, words) {
+    append(w);
+  }
+  _starts.push_back(_text.size());
+}
+
+csPdfMatchText::~csPdfMatchText()
+{
+}
+
+Qt::CaseSensitivity csPdfMatchText::caseSensitivity() const
+{
+  return _cs;
+}
+
+int csPdfMatchText::count() const
+{
+  return _starts.size()-1;
+}
+
+const QString& csPdfMatchText::text() const
+{
+  return _text;
+}
+
+int csPdfMatchText::wordAt(const int pos) const
+{
+  if( pos < 0  ||  pos >= _text.size() ) {
+    return -1;
+  }
+
+  return int(std::upper_bound(_starts.constBegin(), _starts.constEnd(), pos)
+             - _starts.constBegin()) - 1;
+}
+
+int csPdfMatchText::wordStart(const int i) const
+{
+  return _starts[i];
+}
+
+int csPdfMatchText::wordEnd(const int i) const
+{
+  return _starts[i+1]-1;
+}
+
+////// csPdfMatchText - private //////////////////////////////////////////////
+
+void csPdfMatchText::append(const QString& word)
+{
+  _starts.push_back(_text.size());
+  _text += csPdfMatcher::prepare(word, _cs);
+  _text += QLatin1Char(' ');
+}
+
+////// csPdfMultiMatcher - public ////////////////////////////////////////////
+
+csPdfMultiMatcher::csPdfMultiMatcher(const QStringList& patterns,
+                                     const Qt::CaseSensitivity cs)
+  : _cs(cs)
+  , _patterns()
+  , _words()
+  , _same()
+  , _first()
+  , _labels()
+  , _targets()
+  , _fail()
+  , _output()
+  , _dict()
+{
+  // (1) Trie ////////////////////////////////////////////////////////////////
+
+  QVector<QMap<ushort,int> > trie(1);
+  _output.push_back(-1);
+
+  foreach(const QString& p, patterns) {
+    const QStringList words = csPdfPrepareSearch(p);
+    const int id = _patterns.size();
+    _patterns.push_back(csPdfMatcher::prepare(words.join(_L1C(' ')), cs));
+    _words.push_back(words.size());
+    _same.push_back(-1);
+
+    const QString& pattern = _patterns.back();
+    if( pattern.isEmpty() ) {
+      continue;
+    }
+
+    int node = 0;
+    foreach(const QChar c, pattern) {
+      int next = trie[node].value(c.unicode(), -1);
+      if( next < 0 ) {
+        next = trie.size();
+        trie[node].insert(c.unicode(), next);
+        trie.push_back(QMap<ushort,int>());
+        _output.push_back(-1);
+      }
+      node = next;
+    }
+
+    // NOTE: Equal patterns share the node; chain them in order of their ids.
+    if( _output[node] < 0 ) {
+      _output[node] = id;
+    } else {
+      int last = _output[node];
+      while( _same[last] >= 0 ) {
+        last = _same[last];
+      }
+      _same[last] = id;
+    }
+  }
+
+  // (2) Flat Transitions ////////////////////////////////////////////////////
+
+  const int numNodes = trie.size();
+  _first.reserve(numNodes+1);
+  _labels.reserve(numNodes-1);
+  _targets.reserve(numNodes-1);
+  for(int node = 0; node < numNodes; node++) {
+    _first.push_back(_labels.size());
+    for(QMap<ushort,int>::const_iterator it = trie[node].constBegin();
+        it != trie[node].constEnd(); ++it) {
+      _labels.push_back(it.key());
+      _targets.push_back(it.value());
+    }
+  }
+  _first.push_back(_labels.size());
+
+  // (3) Failure & Dictionary Links; Breadth First ///////////////////////////
+
+  _fail.fill(0, numNodes);
+  _dict.fill(-1, numNodes);
+
+  QVector<int> queue;
+  queue.reserve(numNodes);
+  queue.push_back(0);
+  for(int head = 0; head < queue.size(); head++) {
+    const int node = queue[head];
+    for(int e = _first[node]; e < _first[node+1]; e++) {
+      const int child = _targets[e];
+      queue.push_back(child);
+      if( node == 0 ) {
+        continue;
+      }
+
+      int f = _fail[node];
+      int next;
+      while( (next = transition(f, QChar(_labels[e]))) < 0  &&  f != 0 ) {
+        f = _fail[f];
+      }
+      _fail[child] = next >= 0
+          ? next
+          : 0;
+
+      const int fc = _fail[child];
+      _dict[child] = _output[fc] >= 0
+          ? fc
+          : _dict[fc];
+    }
+  }
+}
+
+csPdfMultiMatcher::~csPdfMultiMatcher()
+{
+}
+
+bool csPdfMultiMatcher::isEmpty() const
+{
+  return _first.size() < 2  ||  _first[1] == 0; // Root without transitions
+}
+
+Qt::CaseSensitivity csPdfMultiMatcher::caseSensitivity() const
+{
+  return _cs;
+}
+
+int csPdfMultiMatcher::count() const
+{
+  return _patterns.size();
+}
+
+const QString& csPdfMultiMatcher::pattern(const int id) const
+{
+  return _patterns[id];
+}
+
+int csPdfMultiMatcher::wordCount(const int id) const
+{
+  return _words[id];
+}
+
+csPdfMultiMatches csPdfMultiMatcher::findAll(const csPdfMatchText& hay) const
+{
+  if( isEmpty()  ||  hay.count() < 1  ||  hay.caseSensitivity() != _cs ) {
+    return csPdfMultiMatches();
+  }
+
+  const QString& text = hay.text();
+  QVector<int> lastWord(_patterns.size(), -1);
+
+  csPdfMultiMatches matches;
+  int node = 0;
+  for(int i = 0; i < text.size(); i++) {
+    const QChar c = text[i];
+    int next;
+    while( (next = transition(node, c)) < 0  &&  node != 0 ) {
+      node = _fail[node];
+    }
+    node = next >= 0
+        ? next
+        : 0;
+
+    int hit = _output[node] >= 0
+        ? node
+        : _dict[node];
+    for(; hit >= 0; hit = _dict[hit]) {
+      for(int id = _output[hit]; id >= 0; id = _same[id]) {
+        const int word = hay.wordAt(i+1-_patterns[id].size());
+        // NOTE: A pattern's matches arrive ordered by their start.
+        if( word != lastWord[id] ) {
+          lastWord[id] = word;
+          matches.push_back(csPdfMultiMatch(word, id));
+        }
+      }
+    }
+  }
+
+  qSort(matches);
+
+  return matches;
+}
+
+////// csPdfMultiMatcher - private ///////////////////////////////////////////
+
+int csPdfMultiMatcher::transition(const int node, const QChar c) const
+{
+  const ushort *first = _labels.constData() + _first[node];
+  const ushort *last  = _labels.constData() + _first[node+1];
+  const ushort *it    = std::lower_bound(first, last, c.unicode());
+
+  return it != last  &&  *it == c.unicode()
+      ? _targets[int(it - _labels.constData())]
+      : -1;
+}
@@ -0,0 +1,221 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QThreadPool>
+
+#include <csPDFSearch/csPdfQuickSearch.h>
+#include <csPDFSearch/csPdfSearch.h>
+#include <csPDFSearch/csPdfSearchUtil.h>
+
+#include "internal/csPdfQuickSearchTask.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPdfQuickSearch::csPdfQuickSearch(QObject *parent)
+  : QObject(parent)
+  , _doc()
+  , _pageNo(0)
+  , _cs(Qt::CaseInsensitive)
+  , _text()
+  , _state(new csPdfQuickSearchState())
+  , _watcher(nullptr)
+  , _search(nullptr)
+  , _restartDocument(false)
+  , _numDocumentHits(0)
+{
+  _watcher = new QFutureWatcher<csPdfQuickSearchHits>(this);
+
+  connect(_watcher, &QFutureWatcher<csPdfQuickSearchHits>::finished,
+          this, &csPdfQuickSearch::finishPage);
+
+  // NOTE: Without an index, i.e. csPdfSearch's default.
+  _search = new csPdfSearch(this);
+
+  connect(_search, &csPdfSearch::found,
+          this, &csPdfQuickSearch::storeDocumentResults);
+  connect(_search, &csPdfSearch::finished,
+          this, &csPdfQuickSearch::finishDocument);
+  connect(_search, &csPdfSearch::canceled,
+          this, &csPdfQuickSearch::restartDocument);
+}
+
+csPdfQuickSearch::~csPdfQuickSearch()
+{
+  cancel();
+  _watcher->waitForFinished();
+}
+
+Qt::CaseSensitivity csPdfQuickSearch::caseSensitivity() const
+{
+  return _cs;
+}
+
+void csPdfQuickSearch::setCaseSensitivity(const Qt::CaseSensitivity cs)
+{
+  _cs = cs;
+}
+
+const csPDFiumDocument& csPdfQuickSearch::document() const
+{
+  return _doc;
+}
+
+void csPdfQuickSearch::setDocument(const csPDFiumDocument& doc)
+{
+  cancel();
+  _doc    = doc;
+  _pageNo = 0;
+  _text.clear();
+  // CAUTION: Running tasks keep the previous state.
+  _state  = QSharedPointer<csPdfQuickSearchState>(new csPdfQuickSearchState());
+}
+
+QString csPdfQuickSearch::text() const
+{
+  return _text;
+}
+
+////// public slots //////////////////////////////////////////////////////////
+
+void csPdfQuickSearch::cancel()
+{
+  _watcher->cancel();
+  _restartDocument = false;
+  _search->cancel();
+}
+
+void csPdfQuickSearch::find(const QString& text)
+{
+  _text = text;
+  startPage();
+  startDocument();
+}
+
+void csPdfQuickSearch::setPage(int no)
+{
+  if( _doc.isEmpty() ) {
+    return;
+  }
+
+  const int pageNo = qBound(0, no-1, _doc.pageCount()-1);
+  if( pageNo == _pageNo ) {
+    return;
+  }
+
+  _pageNo = pageNo;
+  if( !_text.isEmpty() ) {
+    startPage();
+  }
+}
+
+////// private slots /////////////////////////////////////////////////////////
+
+void csPdfQuickSearch::finishDocument()
+{
+  if( _restartDocument ) {
+    startDocument();
+    return;
+  }
+
+  emit documentFinished(_numDocumentHits);
+}
+
+void csPdfQuickSearch::finishPage()
+{
+  if( _watcher->isCanceled()  ||  _watcher->future().resultCount() < 1 ) {
+    return;
+  }
+
+  const csPdfQuickSearchHits hits = _watcher->result();
+  emit found(hits.results);
+  emit highlightRequested(hits.rects);
+}
+
+void csPdfQuickSearch::restartDocument()
+{
+  if( _restartDocument ) {
+    startDocument();
+  }
+}
+
+void csPdfQuickSearch::storeDocumentResults(const csPdfSearchResults& results)
+{
+  // NOTE: Results of a superseded query are dropped.
+  if( _restartDocument ) {
+    return;
+  }
+
+  _numDocumentHits += results.size();
+  emit documentFound(results);
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void csPdfQuickSearch::startDocument()
+{
+  if( _search->isRunning() ) {
+    _restartDocument = true;
+    _search->cancel();
+    return;
+  }
+
+  _restartDocument = false;
+  _numDocumentHits = 0;
+
+  const QStringList needles = csPdfPrepareSearch(_text);
+  if( _doc.isEmpty()  ||  needles.isEmpty() ) {
+    return;
+  }
+
+  Qt::MatchFlags flags = Qt::MatchWrap;
+  if( _cs == Qt::CaseSensitive ) {
+    flags |= Qt::MatchCaseSensitive;
+  }
+  _search->start(_doc, needles, _pageNo, flags);
+}
+
+void csPdfQuickSearch::startPage()
+{
+  _watcher->cancel();
+
+  if( _doc.isEmpty()  ||  csPdfPrepareSearch(_text).isEmpty() ) {
+    _watcher->setFuture(QFuture<csPdfQuickSearchHits>());
+    emit found(csPdfSearchResults());
+    emit highlightRequested(QList<QRectF>());
+    return;
+  }
+
+  // NOTE: Not queued behind the document search on csPDFium::textThreadPool().
+  csPdfQuickSearchTask *task = new csPdfQuickSearchTask(_state, _doc, _pageNo,
+                                                        _text, _cs);
+  _watcher->setFuture(task->future());
+  QThreadPool::globalInstance()->start(task);
+}
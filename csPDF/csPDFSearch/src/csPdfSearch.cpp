@@ -29,9 +29,17 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <QDir>
+#include <QThreadPool>
+
+#include <csPDFium/csPDFium.h>
+#include <csPDFium/csPDFiumUtil.h>
+
 #include <csPDFSearch/csPdfSearch.h>
 
 #include "internal/config_Search.h"
+#include "internal/csPdfSearchIndexImpl.h"
+#include "internal/csPdfSearchTask.h"
 #include <csPDFSearch/csPdfSearchUtil.h>
 
 ////// public ////////////////////////////////////////////////////////////////
@@ -40,25 +48,45 @@ csPdfSearch::csPdfSearch(QObject *parent)
   : QObject(parent)
   , _doc()
   , _needles()
+  , _patterns()
+  , _regexp()
   , _cs()
   , _wrap()
-  , _context()
   , _cancel()
   , _running()
   , _startIndex()
-  , _numBlocks()
-  , _numRemain()
-  , _cntBlocks()
-  , _cntRemain()
-  , _cntIndex()
   , _numToDo()
   , _cntDone()
   , _lastProgress()
+  , _indexDir()
+  , _index()
+  , _builder()
+  , _watcher(nullptr)
+  , _indexWatcher(nullptr)
+  , _pending()
+  , _nextBlock()
 {
+  _watcher = new QFutureWatcher<csPdfSearchResults>(this);
+
+  connect(_watcher, &QFutureWatcher<csPdfSearchResults>::finished,
+          this, &csPdfSearch::finishSearch);
+  connect(_watcher, &QFutureWatcher<csPdfSearchResults>::progressValueChanged,
+          this, &csPdfSearch::storeProgress);
+  connect(_watcher, &QFutureWatcher<csPdfSearchResults>::resultReadyAt,
+          this, &csPdfSearch::storeResults);
+
+  _indexWatcher = new QFutureWatcher<csPdfSearchIndex>(this);
+
+  connect(_indexWatcher, &QFutureWatcher<csPdfSearchIndex>::finished,
+          this, &csPdfSearch::openedIndex);
 }
 
 csPdfSearch::~csPdfSearch()
 {
+  // CAUTION: Workers refer to '_cancel'!
+  _cancel = true;
+  _indexWatcher->waitForFinished();
+  _watcher->waitForFinished();
 }
 
 bool csPdfSearch::isRunning() const
@@ -66,42 +94,65 @@ bool csPdfSearch::isRunning() const
   return _running;
 }
 
+QString csPdfSearch::indexDirectory() const
+{
+  return _indexDir;
+}
+
+void csPdfSearch::setIndexDirectory(const QString& dir)
+{
+  if( !_running ) {
+    _indexDir = dir;
+  }
+}
+
 bool csPdfSearch::start(const csPDFiumDocument& doc, const QStringList& needles,
-                        const int startIndex, const Qt::MatchFlags flags,
-                        const int context)
-{
-  if( _running  ||
-      doc.isEmpty()  ||  doc.pageCount() < 1  ||
-      needles.isEmpty()  ||
-      startIndex < 0  ||  startIndex >= doc.pageCount()  ||
-      context < 0 ) {
+                        const int startIndex, const Qt::MatchFlags flags)
+{
+  if( _running  ||  needles.isEmpty() ) {
     return false;
   }
 
-  _doc     = doc;
-  _needles = needles;
-  _context = context;
-  _cs      = flags.testFlag(Qt::MatchCaseSensitive)
-      ? Qt::CaseSensitive
-      : Qt::CaseInsensitive;
-  _wrap    = flags.testFlag(Qt::MatchWrap);
-  _cancel  = false;
+  if( flags.testFlag(Qt::MatchRegExp) ) {
+    return start(doc, needles.join(_L1C(' ')), startIndex, flags);
+  }
 
-  if( _wrap ) {
-    _numToDo = _doc.pageCount();
-  } else {
-    _numToDo = _doc.pageCount() - startIndex;
+  return launch(doc, needles, QStringList(), QRegularExpression(), startIndex, flags);
+}
+
+bool csPdfSearch::start(const csPDFiumDocument& doc, const QString& text,
+                        const int startIndex, const Qt::MatchFlags flags)
+{
+  if( _running  ||  text.isEmpty() ) {
+    return false;
   }
-  _cntDone = 0;
-  _lastProgress = -1;
-  progressUpdate();
 
-  initialize(startIndex, _doc.pageCount());
-  _running = true;
-  QMetaObject::invokeMethod(this, "processSearch", Qt::QueuedConnection);
-  emit started();
+  if( !flags.testFlag(Qt::MatchRegExp) ) {
+    return start(doc, csPdfPrepareSearch(text), startIndex, flags);
+  }
 
-  return true;
+  QRegularExpression::PatternOptions options = QRegularExpression::DontCaptureOption;
+  if( !flags.testFlag(Qt::MatchCaseSensitive) ) {
+    options |= QRegularExpression::CaseInsensitiveOption;
+  }
+
+  // NOTE: Validated once here; every worker compiles its own instance.
+  const QRegularExpression regexp(text, options);
+  if( !regexp.isValid() ) {
+    return false;
+  }
+
+  return launch(doc, QStringList(), QStringList(), regexp, startIndex, flags);
+}
+
+bool csPdfSearch::startPatterns(const csPDFiumDocument& doc, const QStringList& patterns,
+                                const int startIndex, const Qt::MatchFlags flags)
+{
+  if( _running  ||  patterns.isEmpty() ) {
+    return false;
+  }
+
+  return launch(doc, QStringList(), patterns, QRegularExpression(), startIndex, flags);
 }
 
 ////// public slots //////////////////////////////////////////////////////////
@@ -115,82 +166,200 @@ void csPdfSearch::clear()
 {
   if( !_running ) {
     _doc.clear();
+    _index.clear();
   }
 }
 
-////// private ///////////////////////////////////////////////////////////////
+////// private slots /////////////////////////////////////////////////////////
 
-void csPdfSearch::processSearch()
+void csPdfSearch::finishSearch()
 {
-  if( !_running ) {
-    return;
+  // NOTE: Upon cancel, blocks behind a missing block are still reported.
+  foreach(const csPdfSearchResults& results, _pending) {
+    if( !results.isEmpty() ) {
+      emit found(results);
+    }
   }
+  _pending.clear();
 
   if( _cancel ) {
+    _builder.clear();
     _running = false;
     emit canceled();
     return;
   }
 
-  int blockSize = 0;
-  if(        !isBlocksFinished() ) {
-    // Do CSPDF_SEARCH_BLOCKSIZE's Work...
-    blockSize = CSPDF_SEARCH_BLOCKSIZE;
-    _cntBlocks++;
-  } else if(  isBlocksFinished()  &&  !isRemainFinished() ) {
-    // Do _numRemain's Work...
-    blockSize = _numRemain;
-    _cntRemain += _numRemain;
+  writeIndex();
+  _running = false;
+  emit finished();
+}
+
+void csPdfSearch::openedIndex()
+{
+  const QFuture<csPdfSearchIndex> future = _indexWatcher->future();
+  _index = future.resultCount() > 0
+      ? future.result()
+      : csPdfSearchIndex();
+
+  if( !_index.isEmpty()  &&  !_cancel ) {
+    if( _regexp.pattern().isEmpty()  &&  _patterns.isEmpty() ) {
+      searchIndex();
+    } else {
+      searchDocument(_index);
+    }
+    return;
+  }
+
+  // Only a search visiting ALL pages completes the index.
+  if( _wrap  ||  _startIndex == 0 ) {
+    _builder = QSharedPointer<csPdfSearchIndexBuilder>(new csPdfSearchIndexBuilder(_doc.pageCount()));
   }
 
-  if( blockSize != 0 ) {
-    const csPdfSearchResults results =
-        searchPages(_doc.textPages(_cntIndex, blockSize),
-                    _needles, _cs, _context);
+  searchDocument();
+}
+
+void csPdfSearch::storeProgress(int value)
+{
+  _cntDone = value;
+  progressUpdate();
+}
+
+void csPdfSearch::storeResults(int block)
+{
+  _pending.insert(block, _watcher->resultAt(block));
+
+  // NOTE: Blocks are reported in search order, i.e. nearest to the start first.
+  while( _pending.contains(_nextBlock) ) {
+    const csPdfSearchResults results = _pending.take(_nextBlock++);
     if( !results.isEmpty() ) {
       emit found(results);
     }
-    _cntIndex += blockSize;
-    _cntDone  += blockSize;
-    progressUpdate();
   }
+}
 
-  if( isFinished()  &&  _startIndex != 0  &&  _wrap ) {
-    initialize(0, _startIndex);
-    _startIndex = 0;
+////// private ///////////////////////////////////////////////////////////////
+
+bool csPdfSearch::launch(const csPDFiumDocument& doc,
+                         const QStringList& needles, const QStringList& patterns,
+                         const QRegularExpression& regexp,
+                         const int startIndex, const Qt::MatchFlags flags)
+{
+  if( doc.isEmpty()  ||  doc.pageCount() < 1  ||
+      startIndex < 0  ||  startIndex >= doc.pageCount() ) {
+    return false;
   }
 
-  if( !isFinished() ) {
-    QMetaObject::invokeMethod(this, "processSearch", Qt::QueuedConnection);
+  _doc      = doc;
+  _needles  = needles;
+  _patterns = patterns;
+  _regexp   = regexp;
+  _cs       = flags.testFlag(Qt::MatchCaseSensitive)
+      ? Qt::CaseSensitive
+      : Qt::CaseInsensitive;
+  _wrap     = flags.testFlag(Qt::MatchWrap);
+  _cancel   = false;
+
+  if( _wrap ) {
+    _numToDo = _doc.pageCount();
   } else {
-    _running = false;
-    emit finished();
+    _numToDo = _doc.pageCount() - startIndex;
   }
+  _cntDone = 0;
+  _lastProgress = -1;
+  progressUpdate();
+
+  _startIndex = startIndex;
+  _running = true;
+  QMetaObject::invokeMethod(this, "prepareSearch", Qt::QueuedConnection);
+  emit started();
+
+  return true;
 }
 
-void csPdfSearch::initialize(const int start, const int count)
+void csPdfSearch::prepareSearch()
 {
-  _startIndex = start;
-  _numBlocks  = (count - start) / CSPDF_SEARCH_BLOCKSIZE;
-  _numRemain  = (count - start) % CSPDF_SEARCH_BLOCKSIZE;
-  _cntBlocks  = 0;
-  _cntRemain  = 0;
-  _cntIndex   = start;
+  if( !_running ) {
+    return;
+  }
+
+  _builder.clear();
+  if( _indexDir.isEmpty()  ||  _cancel ) {
+    searchDocument();
+    return;
+  }
+
+  // NOTE: Hashing the document is costly; hence it happens on a worker.
+  csPdfSearchOpenTask *task = new csPdfSearchOpenTask(_doc, _indexDir, _index);
+  _indexWatcher->setFuture(task->future());
+  QThreadPool::globalInstance()->start(task);
 }
 
-bool csPdfSearch::isBlocksFinished() const
+void csPdfSearch::searchDocument(const csPdfSearchIndex& index)
 {
-  return _cntBlocks == _numBlocks;
+  _pending.clear();
+  _nextBlock = 0;
+
+  QThreadPool *pool = csPDFium::textThreadPool();
+  const int numBlocks = (_numToDo + CSPDF_SEARCH_BLOCKSIZE-1) / CSPDF_SEARCH_BLOCKSIZE;
+  const int numWorkers = qBound(1, numBlocks, qMax(1, pool->maxThreadCount()));
+
+  const csPdfSearchJobPtr job(new csPdfSearchJob(_doc, _needles, _patterns, _regexp, _cs,
+                                                 _startIndex, _numToDo,
+                                                 &_cancel, index, _builder.data(),
+                                                 numWorkers));
+  for(int i = 0; i < numWorkers; i++) {
+    pool->start(new csPdfSearchTask(job));
+  }
+  _watcher->setFuture(job->result.future());
 }
 
-bool csPdfSearch::isRemainFinished() const
+void csPdfSearch::searchIndex()
 {
-  return _cntRemain == _numRemain;
+  const csPdfSearchResults all = _index.find(_needles, _cs);
+
+  // NOTE: Report in search order, i.e. starting at _startIndex.
+  csPdfSearchResults results;
+  foreach(const csPdfSearchResult& r, all) {
+    if( r.page() >= _startIndex ) {
+      results.push_back(r);
+    }
+  }
+  if( _wrap ) {
+    foreach(const csPdfSearchResult& r, all) {
+      if( r.page() < _startIndex ) {
+        results.push_back(r);
+      }
+    }
+  }
+
+  if( !results.isEmpty() ) {
+    emit found(results);
+  }
+  _cntDone = _numToDo;
+  progressUpdate();
+
+  _running = false;
+  emit finished();
 }
 
-bool csPdfSearch::isFinished()
+void csPdfSearch::writeIndex()
 {
-  return isBlocksFinished()  &&  isRemainFinished();
+  if( _builder.isNull() ) {
+    return;
+  }
+
+  // NOTE: textPages() skips pages failing to load; index them as empty.
+  for(int no = 0; no < _doc.pageCount(); no++) {
+    _builder->addPage(no, csPDFiumTexts());
+  }
+
+  const QByteArray key = csPdfSearchIndex::documentKey(_doc.fileName());
+  const QString filename = csPdfSearchIndex::indexFileName(_indexDir, key);
+  if( !filename.isEmpty()  &&  QDir().mkpath(_indexDir) ) {
+    _builder->write(filename, key);
+  }
+
+  _builder.clear();
 }
 
 void csPdfSearch::progressUpdate()
@@ -202,30 +371,55 @@ void csPdfSearch::progressUpdate()
   _lastProgress = p;
 }
 
-csPdfSearchResults csPdfSearch::searchPages(const csPDFiumTextPages& hay,
-                                            const QStringList& needles,
-                                            const Qt::CaseSensitivity cs,
-                                            const int context)
+csPdfSearchResults csPdfSearch::searchPages(const csPdfSearchPages& hay,
+                                            const csPdfMatchers& needles)
 {
+  if( needles.isEmpty() ) {
+    return csPdfSearchResults();
+  }
+
   csPdfSearchResults results;
-  foreach(const csPDFiumTextPage textPage, hay) {
-    const csPdfFindResults found = needles.size() == 1
-        ? csPdfFindAll(textPage.texts(), needles.front(), cs)
-        : csPdfFindAll(textPage.texts(), needles, cs);
+  foreach(const csPdfSearchPage& page, hay) {
+    // NOTE: The page's text is prepared once & shared by all needles.
+    const csPdfFindResults found = csPdfFindAll(page.second, needles);
     foreach(const int index, found) {
-      int pos = index-context;
-      int n   = needles.size()+2*context;
-      if( pos < 0 ) {
-        pos = 0;
-        n  += index-context; // index-context < 0 !!!
-      }
-      QStringList sl;
-      foreach(const csPDFiumText t, textPage.texts().mid(pos, n)) {
-        sl.push_back(t.text());
-      }
-      results.push_back(csPdfSearchResult(textPage.pageNo(), index, sl));
+      results.push_back(csPdfSearchResult(page.first, index, needles.size()));
+    }
+  } // For Each Page
+
+  return results;
+}
+
+csPdfSearchResults csPdfSearch::searchPages(const csPdfSearchPages& hay,
+                                            const csPdfMultiMatcher& patterns)
+{
+  if( patterns.isEmpty() ) {
+    return csPdfSearchResults();
+  }
+
+  csPdfSearchResults results;
+  foreach(const csPdfSearchPage& page, hay) {
+    // NOTE: One pass over the page's text for all patterns.
+    const csPdfMultiMatches found = patterns.findAll(page.second);
+    foreach(const csPdfMultiMatch& m, found) {
+      results.push_back(csPdfSearchResult(page.first, m.first,
+                                          patterns.wordCount(m.second), m.second));
+    }
+  } // For Each Page
+
+  return results;
+}
+
+csPdfSearchResults csPdfSearch::searchPages(const csPdfSearchPages& hay,
+                                            const QRegularExpression& regexp)
+{
+  csPdfSearchResults results;
+  foreach(const csPdfSearchPage& page, hay) {
+    const csPdfFindSpans found = csPdfFindAll(page.second, regexp);
+    foreach(const csPdfFindSpan& span, found) {
+      results.push_back(csPdfSearchResult(page.first, span.first, span.second));
     }
-  } // For Each Text Page
+  } // For Each Page
 
   return results;
 }
@@ -0,0 +1,593 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <cstring>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include <csPDFium/csPDFiumTextPageIterator.h>
+#include <csPDFium/csPDFiumUtil.h>
+
+#include <csPDFSearch/csPdfSearchIndex.h>
+
+#include "internal/csPdfSearchIndexImpl.h"
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  struct DocumentKey {
+    qint64     size;
+    QDateTime  modified;
+    QByteArray key;
+  };
+
+  typedef QHash<QString,DocumentKey> DocumentKeys;
+
+  struct PostingLess {
+    inline bool operator()(const csPdfIndexPosting& a, const csPdfIndexPosting& b) const
+    {
+      return a.page < b.page  ||  (a.page == b.page  &&  a.index < b.index);
+    }
+  };
+
+  struct TermLess {
+    TermLess(const QStringList& terms)
+      : _terms(terms)
+    {
+    }
+
+    inline bool operator()(const quint32 a, const quint32 b) const
+    {
+      return _terms[a] < _terms[b];
+    }
+
+    const QStringList& _terms;
+  };
+
+  // NOTE: Does 'offset' + 'count' elements of 'size' fit into 'fileSize'?
+  static bool fits(const qint64 fileSize, const quint32 offset,
+                   const qint64 count, const qint64 size)
+  {
+    return offset % 4 == 0  &&  qint64(offset) + count*size <= fileSize;
+  }
+
+} // namespace priv
+
+Q_GLOBAL_STATIC(priv::DocumentKeys, documentKeys)
+Q_GLOBAL_STATIC(QMutex, documentKeysMutex)
+
+////// Mapped Index //////////////////////////////////////////////////////////
+
+bool csPdfSearchIndexImpl::map(const QString& filename)
+{
+  file.setFileName(filename);
+  if( !file.open(QIODevice::ReadOnly) ) {
+    return false;
+  }
+
+  const qint64 size = file.size();
+  if( size < qint64(sizeof(csPdfIndexHeader)) ) {
+    return false;
+  }
+
+  data = file.map(0, size);
+  if( data == nullptr ) {
+    return false;
+  }
+
+  // (1) Header & Sections ///////////////////////////////////////////////////
+
+  header = reinterpret_cast<const csPdfIndexHeader*>(data);
+  if( header->magic != CSPDF_INDEX_MAGIC  ||
+      header->version != CSPDF_INDEX_VERSION  ||
+      !priv::fits(size, header->termsOffset, header->termCount, sizeof(csPdfIndexTerm))  ||
+      !priv::fits(size, header->postingsOffset, header->postingCount, sizeof(csPdfIndexPosting))  ||
+      !priv::fits(size, header->pagesOffset, qint64(header->pageCount)+1, sizeof(quint32))  ||
+      !priv::fits(size, header->wordsOffset, header->wordCount, sizeof(quint32))  ||
+      !priv::fits(size, header->charsOffset, header->charCount, sizeof(ushort)) ) {
+    return false;
+  }
+
+  terms    = reinterpret_cast<const csPdfIndexTerm*>(data + header->termsOffset);
+  postings = reinterpret_cast<const csPdfIndexPosting*>(data + header->postingsOffset);
+  pages    = reinterpret_cast<const quint32*>(data + header->pagesOffset);
+  words    = reinterpret_cast<const quint32*>(data + header->wordsOffset);
+  chars    = reinterpret_cast<const ushort*>(data + header->charsOffset);
+
+  // (2) Contents ////////////////////////////////////////////////////////////
+
+  // CAUTION: A corrupt index must never make us read beyond the mapping!
+  if( pages[0] != 0  ||  pages[header->pageCount] != header->wordCount ) {
+    return false;
+  }
+  for(quint32 i = 0; i < header->pageCount; i++) {
+    if( pages[i] > pages[i+1] ) {
+      return false;
+    }
+  }
+
+  for(quint32 i = 0; i < header->termCount; i++) {
+    if( qint64(terms[i].charOffset) + terms[i].length > header->charCount  ||
+        qint64(terms[i].firstPosting) + terms[i].numPostings > header->postingCount ) {
+      return false;
+    }
+  }
+
+  for(quint32 i = 0; i < header->postingCount; i++) {
+    if( postings[i].page >= header->pageCount  ||
+        postings[i].index >= quint32(wordCount(postings[i].page)) ) {
+      return false;
+    }
+  }
+
+  for(quint32 i = 0; i < header->wordCount; i++) {
+    if( words[i] >= header->termCount ) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////// Builder ///////////////////////////////////////////////////////////////
+
+csPdfSearchIndexBuilder::csPdfSearchIndexBuilder(const int pageCount)
+  : _ids()
+  , _terms()
+  , _pages(qMax(0, pageCount))
+  , _added(qMax(0, pageCount), false)
+  , _numAdded(0)
+{
+}
+
+csPdfSearchIndexBuilder::~csPdfSearchIndexBuilder()
+{
+}
+
+bool csPdfSearchIndexBuilder::isComplete() const
+{
+  return _numAdded == _pages.size();
+}
+
+void csPdfSearchIndexBuilder::addPage(const csPDFiumTextPage& page)
+{
+  addPage(page.pageNo(), page.texts());
+}
+
+void csPdfSearchIndexBuilder::addPage(const int no, const csPDFiumTexts& texts)
+{
+  if( no < 0  ||  no >= _pages.size()  ||  _added[no] ) {
+    return;
+  }
+
+  QVector<quint32>& ids = _pages[no];
+  ids.reserve(texts.size());
+  foreach(const csPDFiumText& t, texts) {
+    ids.push_back(termId(t.text()));
+  }
+
+  _added[no] = true;
+  _numAdded++;
+}
+
+bool csPdfSearchIndexBuilder::write(const QString& filename, const QByteArray& key) const
+{
+  if( key.size() != CSPDF_INDEX_KEYSIZE ) {
+    return false;
+  }
+
+  // (1) Sort Terms //////////////////////////////////////////////////////////
+
+  const quint32 termCount = quint32(_terms.size());
+
+  QVector<quint32> order(termCount);
+  for(quint32 i = 0; i < termCount; i++) {
+    order[i] = i;
+  }
+  qSort(order.begin(), order.end(), priv::TermLess(_terms));
+
+  QVector<quint32> remap(termCount);
+  for(quint32 i = 0; i < termCount; i++) {
+    remap[order[i]] = i;
+  }
+
+  // (2) Terms & Character Pool //////////////////////////////////////////////
+
+  QVector<csPdfIndexTerm> terms(termCount);
+  QVector<ushort> chars;
+  for(quint32 i = 0; i < termCount; i++) {
+    const QString& t = _terms[order[i]];
+    terms[i].charOffset   = quint32(chars.size());
+    terms[i].length       = quint32(t.size());
+    terms[i].firstPosting = 0;
+    terms[i].numPostings  = 0;
+    const int at = chars.size();
+    chars.resize(at + t.size());
+    std::memcpy(chars.data() + at, t.utf16(), t.size()*sizeof(ushort));
+  }
+
+  // (3) Pages & Words ///////////////////////////////////////////////////////
+
+  QVector<quint32> pages(_pages.size()+1, 0);
+  QVector<quint32> words;
+  for(int no = 0; no < _pages.size(); no++) {
+    foreach(const quint32 id, _pages[no]) {
+      words.push_back(remap[id]);
+      terms[remap[id]].numPostings++;
+    }
+    pages[no+1] = quint32(words.size());
+  }
+
+  // (4) Postings; NOTE: Walking the pages in order yields sorted postings. ///
+
+  quint32 postingCount = 0;
+  for(quint32 i = 0; i < termCount; i++) {
+    terms[i].firstPosting = postingCount;
+    postingCount += terms[i].numPostings;
+  }
+
+  QVector<csPdfIndexPosting> postings(postingCount);
+  QVector<quint32> fill(termCount, 0);
+  for(int no = 0; no < _pages.size(); no++) {
+    const quint32 *ids = words.constData() + pages[no];
+    const int count = int(pages[no+1] - pages[no]);
+    for(int index = 0; index < count; index++) {
+      csPdfIndexPosting& p = postings[terms[ids[index]].firstPosting + fill[ids[index]]++];
+      p.page  = quint32(no);
+      p.index = quint32(index);
+    }
+  }
+
+  // (5) Layout //////////////////////////////////////////////////////////////
+
+  csPdfIndexHeader header;
+  std::memset(&header, 0, sizeof(header));
+  header.magic        = CSPDF_INDEX_MAGIC;
+  header.version      = CSPDF_INDEX_VERSION;
+  header.pageCount    = quint32(_pages.size());
+  header.termCount    = termCount;
+  header.postingCount = postingCount;
+  header.wordCount    = quint32(words.size());
+  header.charCount    = quint32(chars.size());
+  std::memcpy(header.key, key.constData(), CSPDF_INDEX_KEYSIZE);
+
+  const qint64 termsOffset    = sizeof(csPdfIndexHeader);
+  const qint64 postingsOffset = termsOffset    + qint64(termCount)*sizeof(csPdfIndexTerm);
+  const qint64 pagesOffset    = postingsOffset + qint64(postingCount)*sizeof(csPdfIndexPosting);
+  const qint64 wordsOffset    = pagesOffset    + qint64(pages.size())*sizeof(quint32);
+  const qint64 charsOffset    = wordsOffset    + qint64(words.size())*sizeof(quint32);
+  const qint64 fileSize       = charsOffset    + qint64(chars.size())*sizeof(ushort);
+  if( fileSize > qint64(0xFFFFFFFF) ) {
+    return false;
+  }
+
+  header.termsOffset    = quint32(termsOffset);
+  header.postingsOffset = quint32(postingsOffset);
+  header.pagesOffset    = quint32(pagesOffset);
+  header.wordsOffset    = quint32(wordsOffset);
+  header.charsOffset    = quint32(charsOffset);
+
+  // (6) Write ///////////////////////////////////////////////////////////////
+
+  QSaveFile file(filename);
+  if( !file.open(QIODevice::WriteOnly) ) {
+    return false;
+  }
+
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(terms.constData()),
+             terms.size()*sizeof(csPdfIndexTerm));
+  file.write(reinterpret_cast<const char*>(postings.constData()),
+             postings.size()*sizeof(csPdfIndexPosting));
+  file.write(reinterpret_cast<const char*>(pages.constData()),
+             pages.size()*sizeof(quint32));
+  file.write(reinterpret_cast<const char*>(words.constData()),
+             words.size()*sizeof(quint32));
+  file.write(reinterpret_cast<const char*>(chars.constData()),
+             chars.size()*sizeof(ushort));
+
+  return file.commit();
+}
+
+quint32 csPdfSearchIndexBuilder::termId(const QString& word)
+{
+  QHash<QString,quint32>::const_iterator it = _ids.constFind(word);
+  if( it != _ids.constEnd() ) {
+    return it.value();
+  }
+
+  const quint32 id = quint32(_terms.size());
+  _terms.push_back(word);
+  _ids.insert(word, id);
+
+  return id;
+}
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPdfSearchIndex::csPdfSearchIndex()
+  : impl()
+{
+}
+
+csPdfSearchIndex::~csPdfSearchIndex()
+{
+}
+
+bool csPdfSearchIndex::isEmpty() const
+{
+  return impl.isNull();
+}
+
+void csPdfSearchIndex::clear()
+{
+  impl.clear();
+}
+
+QString csPdfSearchIndex::fileName() const
+{
+  if( isEmpty() ) {
+    return QString();
+  }
+
+  return impl->file.fileName();
+}
+
+QByteArray csPdfSearchIndex::key() const
+{
+  if( isEmpty() ) {
+    return QByteArray();
+  }
+
+  return QByteArray(impl->header->key, CSPDF_INDEX_KEYSIZE);
+}
+
+int csPdfSearchIndex::pageCount() const
+{
+  if( isEmpty() ) {
+    return 0;
+  }
+
+  return int(impl->header->pageCount);
+}
+
+int csPdfSearchIndex::termCount() const
+{
+  if( isEmpty() ) {
+    return 0;
+  }
+
+  return int(impl->header->termCount);
+}
+
+QStringList csPdfSearchIndex::words(const int page) const
+{
+  if( page < 0  ||  page >= pageCount() ) {
+    return QStringList();
+  }
+
+  QStringList result;
+  const int count = impl->wordCount(page);
+  for(int i = 0; i < count; i++) {
+    result.push_back(impl->text(impl->wordAt(page, i)));
+  }
+
+  return result;
+}
+
+csPdfSearchResults csPdfSearchIndex::find(const QStringList& needles,
+                                          const Qt::CaseSensitivity cs) const
+{
+  if( isEmpty()  ||  needles.isEmpty() ) {
+    return csPdfSearchResults();
+  }
+
+  const int numNeedles = needles.size();
+  if( numNeedles == 1  &&  needles.front().isEmpty() ) {
+    return csPdfSearchResults();
+  }
+
+  // (1) Scan Vocabulary, Verify Phrases /////////////////////////////////////
+
+  // NOTE: Matching terms, not pages, keeps the semantics of csPdfFindAll().
+  QVector<csPdfIndexPosting> hits;
+  for(quint32 id = 0; id < impl->header->termCount; id++) {
+    const QString t = impl->term(id);
+    const bool match = numNeedles == 1
+        ? t.contains(needles.front(), cs)
+        : t.endsWith(needles.front(), cs);
+    if( !match ) {
+      continue;
+    }
+
+    const csPdfIndexTerm& term = impl->terms[id];
+    for(quint32 i = 0; i < term.numPostings; i++) {
+      const csPdfIndexPosting& p = impl->postings[term.firstPosting + i];
+
+      if( numNeedles > 1 ) {
+        const int page  = int(p.page);
+        const int index = int(p.index);
+        if( index+numNeedles > impl->wordCount(page) ) {
+          continue;
+        }
+
+        bool phrase = true;
+        for(int j = 1; j < numNeedles-1  &&  phrase; j++) {
+          phrase = impl->term(impl->wordAt(page, index+j)).compare(needles[j], cs) == 0;
+        }
+        if( !phrase  ||
+            !impl->term(impl->wordAt(page, index+numNeedles-1)).startsWith(needles.back(), cs) ) {
+          continue;
+        }
+      }
+
+      hits.push_back(p);
+    }
+  }
+
+  qSort(hits.begin(), hits.end(), priv::PostingLess());
+
+  // (2) Results /////////////////////////////////////////////////////////////
+
+  csPdfSearchResults results;
+  results.reserve(hits.size());
+  foreach(const csPdfIndexPosting& p, hits) {
+    results.push_back(csPdfSearchResult(int(p.page), int(p.index), numNeedles));
+  }
+
+  return results;
+}
+
+////// public static /////////////////////////////////////////////////////////
+
+QString csPdfSearchIndex::defaultDirectory()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+      + _L1("/csPDFSearch");
+}
+
+QByteArray csPdfSearchIndex::documentKey(const QString& filename)
+{
+  const QFileInfo info(filename);
+  if( filename.isEmpty()  ||  !info.isFile() ) {
+    return QByteArray();
+  }
+
+  // NOTE: Hashing is costly; hence keys are remembered until the file changes.
+  const QString path = info.canonicalFilePath();
+  {
+    QMutexLocker locker(documentKeysMutex());
+    priv::DocumentKeys::const_iterator it = documentKeys()->constFind(path);
+    if( it != documentKeys()->constEnd()  &&
+        it.value().size == info.size()  &&
+        it.value().modified == info.lastModified() ) {
+      return it.value().key;
+    }
+  }
+
+  QFile file(path);
+  if( !file.open(QIODevice::ReadOnly) ) {
+    return QByteArray();
+  }
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  if( !hash.addData(&file) ) {
+    return QByteArray();
+  }
+
+  priv::DocumentKey entry;
+  entry.size     = info.size();
+  entry.modified = info.lastModified();
+  entry.key      = hash.result();
+
+  QMutexLocker locker(documentKeysMutex());
+  documentKeys()->insert(path, entry);
+
+  return entry.key;
+}
+
+QString csPdfSearchIndex::indexFileName(const QString& dir, const QByteArray& key)
+{
+  if( dir.isEmpty()  ||  key.size() != CSPDF_INDEX_KEYSIZE ) {
+    return QString();
+  }
+
+  return QDir(dir).filePath(QString::fromLatin1(key.toHex()) + _L1(CSPDF_INDEX_SUFFIX));
+}
+
+bool csPdfSearchIndex::build(const csPDFiumDocument& doc, const QString& dir)
+{
+  if( doc.isEmpty()  ||  doc.pageCount() < 1 ) {
+    return false;
+  }
+
+  const QByteArray key = documentKey(doc.fileName());
+  const QString filename = indexFileName(dir, key);
+  if( filename.isEmpty()  ||  !QDir().mkpath(dir) ) {
+    return false;
+  }
+
+  csPdfSearchIndexBuilder builder(doc.pageCount());
+
+  csPDFiumTextPageIterator iter(doc);
+  while( iter.hasNext() ) {
+    const int no = iter.nextPageNo();
+    builder.addPage(no, iter.next().texts());
+  }
+
+  return builder.write(filename, key);
+}
+
+csPdfSearchIndex csPdfSearchIndex::open(const csPDFiumDocument& doc, const QString& dir)
+{
+  if( doc.isEmpty() ) {
+    return csPdfSearchIndex();
+  }
+
+  const QByteArray key = documentKey(doc.fileName());
+  const QString filename = indexFileName(dir, key);
+  if( filename.isEmpty()  ||  !QFileInfo(filename).isFile() ) {
+    return csPdfSearchIndex();
+  }
+
+  const csPdfSearchIndex index = open(filename, key);
+  if( index.pageCount() != doc.pageCount() ) {
+    return csPdfSearchIndex();
+  }
+
+  return index;
+}
+
+csPdfSearchIndex csPdfSearchIndex::open(const QString& filename, const QByteArray& key)
+{
+  QSharedPointer<csPdfSearchIndexImpl> impl(new csPdfSearchIndexImpl());
+  if( !impl->map(filename) ) {
+    return csPdfSearchIndex();
+  }
+
+  if( !key.isEmpty()  &&
+      (key.size() != CSPDF_INDEX_KEYSIZE  ||
+       std::memcmp(impl->header->key, key.constData(), CSPDF_INDEX_KEYSIZE) != 0) ) {
+    return csPdfSearchIndex();
+  }
+
+  csPdfSearchIndex index;
+  index.impl = impl;
+
+  return index;
+}
@@ -29,6 +29,8 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <algorithm>
+
 #include <csPDFSearch/csPdfSearchResultsModel.h>
 
 ////// Private ///////////////////////////////////////////////////////////////
@@ -39,16 +41,36 @@ enum Columns {
   Num_Columns
 };
 
+namespace priv {
+
+  struct PageLess {
+    inline bool operator()(const csPdfSearchResult& r, const int page) const
+    {
+      return r.page() < page;
+    }
+
+    inline bool operator()(const int page, const csPdfSearchResult& r) const
+    {
+      return page < r.page();
+    }
+  };
+
+} // namespace priv
+
 ////// public ////////////////////////////////////////////////////////////////
 
 csPdfSearchResultsModel::csPdfSearchResultsModel(QObject *parent)
   : QAbstractTableModel(parent)
-  , _results()
+  , _rows()
+  , _cache()
+  , _contextWidth(2)
+  , _loading()
 {
 }
 
 csPdfSearchResultsModel::~csPdfSearchResultsModel()
 {
+  cancelContexts();
 }
 
 int csPdfSearchResultsModel::columnCount(const QModelIndex& /*parent*/) const
@@ -65,9 +87,14 @@ QVariant csPdfSearchResultsModel::data(const QModelIndex& index, int role) const
   if( 0 <= index.row()  &&  index.row() < rowCount() ) {
     if( role == Qt::DisplayRole ) {
       if(        index.column() == Col_Page ) {
-        return _results[index.row()].page()+1;
+        return _rows[index.row()].page()+1;
       } else if( index.column() == Col_Context ) {
-        return _results[index.row()].contextString();
+        const csPdfSearchResult& result = _rows[index.row()];
+        if( !_cache.contains(result.page()) ) {
+          requestContext(result.page());
+          return QString();
+        }
+        return _cache.contextString(result, _contextWidth);
       }
     }
   }
@@ -107,7 +134,32 @@ QVariant csPdfSearchResultsModel::headerData(int section, Qt::Orientation orient
 
 int csPdfSearchResultsModel::rowCount(const QModelIndex& /*parent*/) const
 {
-  return _results.size();
+  return _rows.size();
+}
+
+csPdfSearchResult csPdfSearchResultsModel::result(const int row) const
+{
+  if( row < 0  ||  row >= _rows.size() ) {
+    return csPdfSearchResult();
+  }
+
+  return _rows[row];
+}
+
+csPdfSearchTextCache csPdfSearchResultsModel::textCache() const
+{
+  return _cache;
+}
+
+void csPdfSearchResultsModel::setTextCache(const csPdfSearchTextCache& cache,
+                                           const int contextWidth)
+{
+  cancelContexts();
+  _cache        = cache;
+  _contextWidth = qMax(0, contextWidth);
+  if( !_rows.isEmpty() ) {
+    emit dataChanged(index(0, Col_Context), index(_rows.size()-1, Col_Context));
+  }
 }
 
 ////// public slots //////////////////////////////////////////////////////////
@@ -115,7 +167,7 @@ int csPdfSearchResultsModel::rowCount(const QModelIndex& /*parent*/) const
 void csPdfSearchResultsModel::clear()
 {
   beginResetModel();
-  _results.clear();
+  _rows.clear();
   endResetModel();
 }
 
@@ -125,8 +177,84 @@ void csPdfSearchResultsModel::insertResults(const csPdfSearchResults& incoming)
     return;
   }
 
-  beginResetModel();
-  _results += incoming;
-  qSort(_results);
-  endResetModel();
+  csPdfSearchResults batch = incoming;
+  std::sort(batch.begin(), batch.end());
+
+  // NOTE: One insertion per run of results sharing the position.
+  int i = 0;
+  while( i < batch.size() ) {
+    const int pos = int(std::upper_bound(_rows.constBegin(), _rows.constEnd(), batch[i])
+                        - _rows.constBegin());
+    int j = i+1;
+    while( j < batch.size()  &&
+           (pos == _rows.size()  ||  batch[j] < _rows[pos]) ) {
+      j++;
+    }
+
+    const int count = j-i;
+    const int size  = _rows.size();
+    beginInsertRows(QModelIndex(), pos, pos+count-1);
+    _rows.resize(size+count);
+    std::copy_backward(_rows.begin()+pos, _rows.begin()+size, _rows.end());
+    std::copy(batch.constBegin()+i, batch.constBegin()+j, _rows.begin()+pos);
+    endInsertRows();
+
+    i = j;
+  }
+}
+
+////// private slots /////////////////////////////////////////////////////////
+
+void csPdfSearchResultsModel::showContext()
+{
+  QFutureWatcher<int> *watcher = dynamic_cast<QFutureWatcher<int>*>(sender());
+  if( watcher == nullptr ) {
+    return;
+  }
+
+  _loading.remove(_loading.key(watcher));
+  watcher->deleteLater();
+
+  const QFuture<int> future = watcher->future();
+  if( future.isCanceled()  ||  future.resultCount() < 1 ) {
+    return;
+  }
+
+  // NOTE: Rows are ordered by page, i.e. the page's rows are contiguous.
+  const int page = future.result();
+  const int first = int(std::lower_bound(_rows.constBegin(), _rows.constEnd(),
+                                         page, priv::PageLess()) - _rows.constBegin());
+  const int  last = int(std::upper_bound(_rows.constBegin(), _rows.constEnd(),
+                                         page, priv::PageLess()) - _rows.constBegin()) - 1;
+  if( first <= last ) {
+    emit dataChanged(index(first, Col_Context), index(last, Col_Context));
+  }
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void csPdfSearchResultsModel::cancelContexts()
+{
+  foreach(QFutureWatcher<int> *watcher, _loading) {
+    watcher->disconnect(this);
+    watcher->cancel();
+    watcher->deleteLater();
+  }
+  _loading.clear();
+}
+
+void csPdfSearchResultsModel::requestContext(const int page) const
+{
+  if( _cache.isEmpty()  ||  _loading.contains(page) ) {
+    return;
+  }
+
+  csPdfSearchResultsModel *self = const_cast<csPdfSearchResultsModel*>(this);
+
+  QFutureWatcher<int> *watcher = new QFutureWatcher<int>(self);
+  connect(watcher, &QFutureWatcher<int>::finished,
+          self, &csPdfSearchResultsModel::showContext);
+  watcher->setFuture(_cache.loadAsync(page));
+
+  _loading.insert(page, watcher);
 }
@@ -0,0 +1,196 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThreadPool>
+
+#include <csPDFium/csPDFium.h>
+#include <csPDFium/csPDFiumTextPage.h>
+#include <csPDFium/csPDFiumUtil.h>
+
+#include <csPDFSearch/csPdfSearchTextCache.h>
+
+#include "internal/csPdfSearchTextCacheImpl.h"
+#include "internal/csPdfSearchTextTask.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPdfSearchTextCache::csPdfSearchTextCache()
+  : impl()
+{
+}
+
+csPdfSearchTextCache::csPdfSearchTextCache(const csPDFiumDocument& doc,
+                                           const csPdfSearchIndex& index)
+  : impl()
+{
+  if( doc.isEmpty()  &&  index.isEmpty() ) {
+    return;
+  }
+
+  impl = QSharedPointer<csPdfSearchTextCacheImpl>(new csPdfSearchTextCacheImpl(doc, index));
+}
+
+csPdfSearchTextCache::~csPdfSearchTextCache()
+{
+}
+
+bool csPdfSearchTextCache::isEmpty() const
+{
+  return impl.isNull();
+}
+
+void csPdfSearchTextCache::clear()
+{
+  impl.clear();
+}
+
+bool csPdfSearchTextCache::contains(const int page) const
+{
+  if( isEmpty() ) {
+    return false;
+  }
+
+  QMutexLocker locker(&impl->mutex);
+  return impl->pages.contains(page);
+}
+
+QFuture<int> csPdfSearchTextCache::loadAsync(const int page) const
+{
+  csPdfSearchTextTask *task = new csPdfSearchTextTask(*this, page);
+  const QFuture<int> future = task->future();
+
+  csPDFium::textThreadPool()->start(task);
+
+  return future;
+}
+
+int csPdfSearchTextCache::maxPages() const
+{
+  if( isEmpty() ) {
+    return 0;
+  }
+
+  QMutexLocker locker(&impl->mutex);
+  return impl->pages.maxCost();
+}
+
+void csPdfSearchTextCache::setMaxPages(const int max)
+{
+  if( isEmpty()  ||  max < 1 ) {
+    return;
+  }
+
+  QMutexLocker locker(&impl->mutex);
+  impl->pages.setMaxCost(max);
+}
+
+QStringList csPdfSearchTextCache::words(const int page) const
+{
+  csPdfSearchPageText text;
+  lookup(page, false, &text);
+
+  return text.words;
+}
+
+QStringList csPdfSearchTextCache::context(const csPdfSearchResult& result,
+                                          const int width) const
+{
+  if( result.isEmpty()  ||  width < 0 ) {
+    return QStringList();
+  }
+
+  int pos = result.index()-width;
+  int n   = result.span()+2*width;
+  if( pos < 0 ) {
+    n  += pos;
+    pos = 0;
+  }
+
+  return words(result.page()).mid(pos, n);
+}
+
+QString csPdfSearchTextCache::contextString(const csPdfSearchResult& result,
+                                            const int width) const
+{
+  return context(result, width).join(_L1C(' '));
+}
+
+QList<QRectF> csPdfSearchTextCache::rects(const csPdfSearchResult& result) const
+{
+  csPdfSearchPageText text;
+  if( result.isEmpty()  ||  !lookup(result.page(), true, &text) ) {
+    return QList<QRectF>();
+  }
+
+  return text.rects.mid(result.index(), result.span()).toList();
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+bool csPdfSearchTextCache::lookup(const int page, const bool withRects,
+                                  csPdfSearchPageText *text) const
+{
+  if( isEmpty()  ||  page < 0 ) {
+    return false;
+  }
+
+  {
+    QMutexLocker locker(&impl->mutex);
+    const csPdfSearchPageText *cached = impl->pages.object(page);
+    if( cached != nullptr  &&  (!withRects  ||  cached->rects.size() == cached->words.size()) ) {
+      *text = *cached;
+      return true;
+    }
+  }
+
+  // NOTE: Looked up unlocked; a concurrent miss merely repeats the work.
+  csPdfSearchPageText result;
+  if( !withRects  &&
+      !impl->index.isEmpty()  &&  page < impl->index.pageCount() ) {
+    result.words = impl->index.words(page);
+  } else if( !impl->doc.isEmpty()  &&  page < impl->doc.pageCount() ) {
+    const csPDFiumTexts texts = impl->doc.textPage(page).texts();
+    result.rects.reserve(texts.size());
+    foreach(const csPDFiumText& t, texts) {
+      result.words.push_back(t.text());
+      result.rects.push_back(t.rect());
+    }
+  } else {
+    return false;
+  }
+
+  QMutexLocker locker(&impl->mutex);
+  impl->pages.insert(page, new csPdfSearchPageText(result));
+  *text = result;
+
+  return true;
+}
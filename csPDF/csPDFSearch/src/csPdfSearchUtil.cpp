@@ -35,6 +35,83 @@
 
 #include <csPDFium/csPDFiumUtil.h>
 
+namespace priv {
+
+  static csPdfFindResults findAll(const csPdfMatchText& hay,
+                                  const csPdfMatchers& needles,
+                                  const int position, const bool first)
+  {
+    const int count = hay.count();
+    const int numNeedles = needles.size();
+    if( count < 1  ||  numNeedles < 1  ||  numNeedles > count  ||
+        position < 0  ||  position > count-numNeedles ) {
+      return csPdfFindResults();
+    }
+
+    foreach(const csPdfMatcher& m, needles) {
+      if( m.isEmpty()  ||  m.caseSensitivity() != hay.caseSensitivity() ) {
+        return csPdfFindResults();
+      }
+    }
+
+    const QChar  *text = hay.text().constData();
+    const int     size = hay.text().size();
+    const csPdfMatcher& front = needles.front();
+
+    csPdfFindResults results;
+    int from = hay.wordStart(position);
+    int pos;
+    while( (pos = front.indexIn(text, size, from)) >= 0 ) {
+      const int word = hay.wordAt(pos);
+      const int end  = hay.wordEnd(word);
+
+      // (1) One Needle: Contained in a Word /////////////////////////////////
+
+      if( numNeedles == 1 ) {
+        if( pos+front.size() > end ) { // Spans words
+          from = pos+1;
+          continue;
+        }
+        results.push_back(word);
+        if( first ) {
+          break;
+        }
+        from = end+1;
+        continue;
+      }
+
+      // (2) Phrase: Word Ends with First, Equals Middle, Starts with Last ///
+
+      if( pos+front.size() != end ) {
+        from = pos+1;
+        continue;
+      }
+      if( word > count-numNeedles ) {
+        break;
+      }
+
+      bool match = true;
+      for(int j = 1; j < numNeedles  &&  match; j++) {
+        const int    start  = hay.wordStart(word+j);
+        const int    length = hay.wordEnd(word+j)-start;
+        match = j < numNeedles-1
+            ? needles[j].equals(text+start, length)
+            : needles[j].isPrefixOf(text+start, length);
+      }
+      if( match ) {
+        results.push_back(word);
+        if( first ) {
+          break;
+        }
+      }
+      from = end+1;
+    }
+
+    return results;
+  }
+
+} // namespace priv
+
 CS_PDFSEARCH_EXPORT int csPdfFind(const csPDFiumTexts& hay,
                                   const QString& needle,
                                   const int position,
@@ -45,13 +122,8 @@ CS_PDFSEARCH_EXPORT int csPdfFind(const csPDFiumTexts& hay,
     return -1;
   }
 
-  for(int i = position; i < hay.size(); i++) {
-    if( hay[i].text().contains(needle, cs) ) {
-      return i;
-    }
-  }
-
-  return -1;
+  return csPdfFind(csPdfMatchText(hay, cs),
+                   csPdfMatchers() << csPdfMatcher(needle, cs), position);
 }
 
 CS_PDFSEARCH_EXPORT csPdfFindResults csPdfFindAll(const csPDFiumTexts& hay,
@@ -62,14 +134,8 @@ CS_PDFSEARCH_EXPORT csPdfFindResults csPdfFindAll(const csPDFiumTexts& hay,
     return csPdfFindResults();
   }
 
-  csPdfFindResults results;
-  for(int i = 0; i < hay.size(); i++) {
-    if( hay[i].text().contains(needle, cs) ) {
-      results.push_back(i);
-    }
-  }
-
-  return results;
+  return csPdfFindAll(csPdfMatchText(hay, cs),
+                      csPdfMatchers() << csPdfMatcher(needle, cs));
 }
 
 CS_PDFSEARCH_EXPORT int csPdfFind(const csPDFiumTexts& hay,
@@ -83,76 +149,109 @@ CS_PDFSEARCH_EXPORT int csPdfFind(const csPDFiumTexts& hay,
     return -1;
   }
 
-  for(int i = position; i <= hay.size()-needles.size(); i++) {
-    int hits(0);
+  return csPdfFind(csPdfMatchText(hay, cs),
+                   csPdfCompileMatchers(needles, cs), position);
+}
 
-    if( hay[i].text().endsWith(needles.front(), cs) ) {
-      hits++;
-    } else {
+CS_PDFSEARCH_EXPORT csPdfFindResults csPdfFindAll(const csPDFiumTexts& hay,
+                                                  const QStringList& needles,
+                                                  const Qt::CaseSensitivity cs)
+{
+  if( hay.isEmpty()  ||  needles.isEmpty()  ||
+      needles.size() < 2  ||  needles.size() > hay.size() ) {
+    return csPdfFindResults();
+  }
+
+  return csPdfFindAll(csPdfMatchText(hay, cs),
+                      csPdfCompileMatchers(needles, cs));
+}
+
+CS_PDFSEARCH_EXPORT int csPdfFind(const csPdfMatchText& hay,
+                                  const csPdfMatchers& needles,
+                                  const int position)
+{
+  const csPdfFindResults results = priv::findAll(hay, needles, position, true);
+
+  return results.isEmpty()
+      ? -1
+      : results.front();
+}
+
+CS_PDFSEARCH_EXPORT csPdfFindResults csPdfFindAll(const csPdfMatchText& hay,
+                                                  const csPdfMatchers& needles)
+{
+  return priv::findAll(hay, needles, 0, false);
+}
+
+CS_PDFSEARCH_EXPORT csPdfFindSpans csPdfFindAll(const csPdfMatchText& hay,
+                                                const QRegularExpression& regexp)
+{
+  if( hay.count() < 1  ||  !regexp.isValid()  ||  regexp.pattern().isEmpty() ) {
+    return csPdfFindSpans();
+  }
+
+  csPdfFindSpans results;
+  QRegularExpressionMatchIterator it = regexp.globalMatch(hay.text());
+  while( it.hasNext() ) {
+    const QRegularExpressionMatch m = it.next();
+    if( m.capturedLength() < 1 ) {
       continue;
     }
 
-    for(int j = 1; j < needles.size()-1; j++) {
-      if( hay[i+j].text().compare(needles[j], cs) == 0 ) {
-        hits++;
-      } else {
-        break;
-      }
+    // NOTE: A match starting at a separator starts with the next word.
+    int first = hay.wordAt(m.capturedStart());
+    if( m.capturedStart() == hay.wordEnd(first) ) {
+      first++;
     }
-
-    if( hay[i+needles.size()-1].text().startsWith(needles.back(), cs) ) {
-      hits++;
-    } else {
+    const int last = hay.wordAt(m.capturedEnd()-1);
+    if( first > last  ||
+        (!results.isEmpty()  &&  results.back().first == first) ) {
       continue;
     }
 
-    if( hits == needles.size() ) {
-      return i;
-    }
+    results.push_back(csPdfFindSpan(first, last-first+1));
   }
 
-  return -1;
+  return results;
 }
 
-CS_PDFSEARCH_EXPORT csPdfFindResults csPdfFindAll(const csPDFiumTexts& hay,
-                                                  const QStringList& needles,
-                                                  const Qt::CaseSensitivity cs)
+CS_PDFSEARCH_EXPORT bool csPdfMatchAt(const csPdfMatchText& hay,
+                                      const csPdfMatchers& needles,
+                                      const int index)
 {
-  if( hay.isEmpty()  ||  needles.isEmpty()  ||
-      needles.size() < 2  ||  needles.size() > hay.size() ) {
-    return csPdfFindResults();
+  const int numNeedles = needles.size();
+  if( numNeedles < 1  ||  index < 0  ||  index > hay.count()-numNeedles ) {
+    return false;
   }
 
-  csPdfFindResults results;
-  for(int i = 0; i <= hay.size()-needles.size(); i++) {
-    int hits(0);
-
-    if( hay[i].text().endsWith(needles.front(), cs) ) {
-      hits++;
-    } else {
-      continue;
+  foreach(const csPdfMatcher& m, needles) {
+    if( m.isEmpty()  ||  m.caseSensitivity() != hay.caseSensitivity() ) {
+      return false;
     }
+  }
 
-    for(int j = 1; j < needles.size()-1; j++) {
-      if( hay[i+j].text().compare(needles[j], cs) == 0 ) {
-        hits++;
-      } else {
-        break;
-      }
-    }
+  const QChar *text = hay.text().constData();
+  for(int j = 0; j < numNeedles; j++) {
+    const int start  = hay.wordStart(index+j);
+    const int length = hay.wordEnd(index+j)-start;
 
-    if( hay[i+needles.size()-1].text().startsWith(needles.back(), cs) ) {
-      hits++;
+    bool match;
+    if(        numNeedles == 1 ) {
+      match = needles[j].indexIn(text, start+length, start) >= 0;
+    } else if( j == 0 ) {
+      match = needles[j].isSuffixOf(text+start, length);
+    } else if( j < numNeedles-1 ) {
+      match = needles[j].equals(text+start, length);
     } else {
-      continue;
+      match = needles[j].isPrefixOf(text+start, length);
     }
 
-    if( hits == needles.size() ) {
-      results.push_back(i);
+    if( !match ) {
+      return false;
     }
   }
 
-  return results;
+  return true;
 }
 
 CS_PDFSEARCH_EXPORT QStringList csPdfPrepareSearch(const QString& text)
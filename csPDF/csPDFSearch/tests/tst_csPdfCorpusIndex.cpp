@@ -0,0 +1,161 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <csPDFium/csPDFium.h>
+#include <csPDFium/csPDFiumUtil.h>
+
+#include <csPDFSearch/csPdfCorpusIndex.h>
+
+////// Data //////////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  // NOTE: A single empty page; PDFium rebuilds the missing cross-reference.
+  static const char *PDF_DOCUMENT =
+      "%PDF-1.4\n"
+      "1 0 obj << /Type /Catalog /Pages 2 0 R >> endobj\n"
+      "2 0 obj << /Type /Pages /Kids [3 0 R] /Count 1 >> endobj\n"
+      "3 0 obj << /Type /Page /Parent 2 0 R /MediaBox [0 0 200 200] >> endobj\n"
+      "trailer << /Root 1 0 R >>\n"
+      "%%EOF\n";
+
+  static bool writeFile(const QString& filename, const QByteArray& data)
+  {
+    QFile file(filename);
+    if( !file.open(QIODevice::WriteOnly) ) {
+      return false;
+    }
+
+    return file.write(data) == data.size();
+  }
+
+  static bool update(csPdfCorpusIndex *corpus)
+  {
+    QSignalSpy spy(corpus, SIGNAL(finished()));
+    if( !corpus->update() ) {
+      return false;
+    }
+
+    return spy.count() > 0  ||  spy.wait(30000);
+  }
+
+  typedef QMap<QString,csPdfCorpusEntry> Entries; // By File
+
+  static Entries entries(const csPdfCorpusIndex& corpus)
+  {
+    Entries result;
+    foreach(const csPdfCorpusEntry& entry, corpus.entries()) {
+      result.insert(entry.fileName, entry);
+    }
+
+    return result;
+  }
+
+} // namespace priv
+
+////// Test //////////////////////////////////////////////////////////////////
+
+class tst_csPdfCorpusIndex : public QObject {
+  Q_OBJECT
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void manifest();
+};
+
+void tst_csPdfCorpusIndex::initTestCase()
+{
+  csPDFium::initialize();
+}
+
+void tst_csPdfCorpusIndex::cleanupTestCase()
+{
+  csPDFium::destroy();
+}
+
+// NOTE: A second index of the same root reads the first one's manifest.
+void tst_csPdfCorpusIndex::manifest()
+{
+  QTemporaryDir rootDir;
+  QTemporaryDir indexDir;
+  QVERIFY(rootDir.isValid());
+  QVERIFY(indexDir.isValid());
+
+  const QDir root(rootDir.path());
+  QVERIFY(root.mkdir(_L1("sub")));
+  QVERIFY(priv::writeFile(root.filePath(_L1("empty.pdf")),
+                          QByteArray(priv::PDF_DOCUMENT)));
+  QVERIFY(priv::writeFile(root.filePath(_L1("sub/broken.pdf")),
+                          QByteArray("Not a PDF document.")));
+  QVERIFY(priv::writeFile(root.filePath(_L1("ignored.txt")),
+                          QByteArray(priv::PDF_DOCUMENT)));
+
+  priv::Entries written;
+  {
+    csPdfCorpusIndex corpus(root.path(), indexDir.path());
+    QVERIFY(corpus.entries().isEmpty());
+    QVERIFY(priv::update(&corpus));
+    written = priv::entries(corpus);
+  }
+  QCOMPARE(written.size(), 2);
+
+  const QString broken = QFileInfo(root.filePath(_L1("sub/broken.pdf"))).canonicalFilePath();
+  QVERIFY(written.contains(broken));
+  QVERIFY(!written[broken].isValid());
+
+  csPdfCorpusIndex corpus(root.path(), indexDir.path());
+  const priv::Entries read = priv::entries(corpus);
+  QCOMPARE(read.keys(), written.keys());
+  foreach(const QString& filename, written.keys()) {
+    const csPdfCorpusEntry& w = written[filename];
+    const csPdfCorpusEntry& r = read[filename];
+    QCOMPARE(r.fileName,  w.fileName);
+    QCOMPARE(r.size,      w.size);
+    QCOMPARE(r.modified,  w.modified);
+    QCOMPARE(r.key,       w.key);
+    QCOMPARE(r.pageCount, w.pageCount);
+    QVERIFY(r.isCurrent(QFileInfo(filename)));
+  }
+
+  // NOTE: Unchanged files are not indexed again, i.e. update() finishes at once.
+  QSignalSpy spy(&corpus, SIGNAL(finished()));
+  QVERIFY(corpus.update());
+  QCOMPARE(spy.count(), 1);
+  QCOMPARE(priv::entries(corpus).keys(), written.keys());
+  QCOMPARE(csPdfCorpusIndex(root.path(), indexDir.path()).entries().size(), 2);
+}
+
+QTEST_GUILESS_MAIN(tst_csPdfCorpusIndex)
+
+#include "tst_csPdfCorpusIndex.moc"
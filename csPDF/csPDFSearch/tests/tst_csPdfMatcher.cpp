@@ -0,0 +1,131 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <csPDFSearch/csPdfMatcher.h>
+#include <csPDFSearch/csPdfSearchUtil.h>
+
+#include "tst_csPdfSearchData.h"
+
+////// Test //////////////////////////////////////////////////////////////////
+
+class tst_csPdfMatcher : public QObject {
+  Q_OBJECT
+private slots:
+  void findAll_data();
+  void findAll();
+  void multiFindAll_data();
+  void multiFindAll();
+};
+
+void tst_csPdfMatcher::findAll_data()
+{
+  QTest::addColumn<int>("page");
+  QTest::addColumn<QString>("query");
+  QTest::addColumn<bool>("insensitive");
+
+  for(int no = 0; no < priv::PAGE_COUNT; no++) {
+    foreach(const QString& q, priv::queries()) {
+      const QByteArray name = QByteArray::number(no) + ": " + q.toUtf8();
+      QTest::newRow((name + " (cs)").constData()) << no << q << false;
+      QTest::newRow((name + " (ci)").constData()) << no << q << true;
+    }
+  }
+}
+
+void tst_csPdfMatcher::findAll()
+{
+  QFETCH(int, page);
+  QFETCH(QString, query);
+  QFETCH(bool, insensitive);
+
+  const Qt::CaseSensitivity cs = insensitive
+      ? Qt::CaseInsensitive
+      : Qt::CaseSensitive;
+  const QStringList hay = priv::page(page);
+  const QStringList needles = csPdfPrepareSearch(query);
+  const csPdfFindResults expected = ref::findAll(hay, needles, cs);
+
+  const csPDFiumTexts texts = priv::texts(hay);
+  if( needles.size() == 1 ) {
+    QCOMPARE(csPdfFindAll(texts, needles.front(), cs), expected);
+  } else {
+    QCOMPARE(csPdfFindAll(texts, needles, cs), expected);
+  }
+
+  const csPdfMatchText text(hay, cs);
+  const csPdfMatchers matchers = csPdfCompileMatchers(needles, cs);
+  QCOMPARE(csPdfFindAll(text, matchers), expected);
+  QCOMPARE(csPdfFind(text, matchers), expected.isEmpty() ? -1 : expected.front());
+  for(int i = 0; i <= hay.size()-needles.size(); i++) {
+    QCOMPARE(csPdfMatchAt(text, matchers, i), expected.contains(i));
+  }
+}
+
+void tst_csPdfMatcher::multiFindAll_data()
+{
+  QTest::addColumn<int>("page");
+  QTest::addColumn<bool>("insensitive");
+
+  for(int no = 0; no < priv::PAGE_COUNT; no++) {
+    const QByteArray name = QByteArray::number(no);
+    QTest::newRow((name + " (cs)").constData()) << no << false;
+    QTest::newRow((name + " (ci)").constData()) << no << true;
+  }
+}
+
+void tst_csPdfMatcher::multiFindAll()
+{
+  QFETCH(int, page);
+  QFETCH(bool, insensitive);
+
+  const Qt::CaseSensitivity cs = insensitive
+      ? Qt::CaseInsensitive
+      : Qt::CaseSensitive;
+  const QStringList hay = priv::page(page);
+  const QStringList patterns = priv::queries();
+
+  QMap<csPdfMultiMatch,bool> expected; // Ordered by (word, pattern)
+  for(int id = 0; id < patterns.size(); id++) {
+    foreach(const int word, ref::findAll(hay, csPdfPrepareSearch(patterns[id]), cs)) {
+      expected.insert(csPdfMultiMatch(word, id), true);
+    }
+  }
+
+  const csPdfMultiMatcher matcher(patterns, cs);
+  QCOMPARE(matcher.count(), patterns.size());
+  QCOMPARE(matcher.findAll(csPdfMatchText(hay, cs)), expected.keys());
+}
+
+QTEST_APPLESS_MAIN(tst_csPdfMatcher)
+
+#include "tst_csPdfMatcher.moc"
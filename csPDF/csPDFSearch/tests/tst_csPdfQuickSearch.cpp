@@ -0,0 +1,134 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include "internal/csPdfQuickSearchTask.h"
+
+#include "tst_csPdfSearchData.h"
+
+////// Data //////////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  // NOTE: The page's text is preset; the task never touches the document.
+  static csPdfQuickSearchStatePtr state(const int no, const Qt::CaseSensitivity cs)
+  {
+    const QStringList words = page(no);
+
+    csPdfQuickSearchStatePtr result(new csPdfQuickSearchState());
+    result->pageNo = no;
+    result->cs     = cs;
+    result->text   = QSharedPointer<csPdfMatchText>(new csPdfMatchText(words, cs));
+    for(int i = 0; i < words.size(); i++) {
+      result->rects.push_back(QRectF(i, 0, 1, 1));
+    }
+
+    return result;
+  }
+
+  static csPdfFindResults search(const csPdfQuickSearchStatePtr& state, const int no,
+                                 const QString& query, const Qt::CaseSensitivity cs)
+  {
+    csPdfQuickSearchTask task(state, csPDFiumDocument(), no, query, cs);
+    task.run();
+
+    const QFuture<csPdfQuickSearchHits> future = task.future();
+    if( future.resultCount() < 1 ) {
+      return csPdfFindResults();
+    }
+
+    csPdfFindResults result;
+    foreach(const csPdfSearchResult& r, future.result().results) {
+      result.push_back(r.index());
+    }
+
+    return result;
+  }
+
+} // namespace priv
+
+////// Test //////////////////////////////////////////////////////////////////
+
+class tst_csPdfQuickSearch : public QObject {
+  Q_OBJECT
+private slots:
+  void narrowDown_data();
+  void narrowDown();
+};
+
+void tst_csPdfQuickSearch::narrowDown_data()
+{
+  QTest::addColumn<int>("page");
+  QTest::addColumn<QString>("query");
+  QTest::addColumn<bool>("insensitive");
+
+  for(int no = 0; no < priv::PAGE_COUNT; no++) {
+    foreach(const QString& q, priv::queries()) {
+      const QByteArray name = QByteArray::number(no) + ": " + q.toUtf8();
+      QTest::newRow((name + " (cs)").constData()) << no << q << false;
+      QTest::newRow((name + " (ci)").constData()) << no << q << true;
+    }
+  }
+}
+
+// NOTE: Typing 'query' one character at a time narrows down the previous
+//       hits; every step must yield the hits of a fresh search.
+void tst_csPdfQuickSearch::narrowDown()
+{
+  QFETCH(int, page);
+  QFETCH(QString, query);
+  QFETCH(bool, insensitive);
+
+  const Qt::CaseSensitivity cs = insensitive
+      ? Qt::CaseInsensitive
+      : Qt::CaseSensitive;
+  const csPdfQuickSearchStatePtr typing = priv::state(page, cs);
+
+  for(int len = 1; len <= query.size(); len++) {
+    const QString prefix = query.left(len);
+    const QStringList needles = csPdfPrepareSearch(prefix);
+    if( needles.isEmpty() ) {
+      continue;
+    }
+
+    const csPdfFindResults narrowed = priv::search(typing, page, prefix, cs);
+    QCOMPARE(typing->query, prefix);
+
+    const csPdfFindResults fresh = priv::search(priv::state(page, cs), page, prefix, cs);
+    QCOMPARE(narrowed, fresh);
+    QCOMPARE(fresh, ref::findAll(priv::page(page), needles, cs));
+  }
+}
+
+QTEST_APPLESS_MAIN(tst_csPdfQuickSearch)
+
+#include "tst_csPdfQuickSearch.moc"
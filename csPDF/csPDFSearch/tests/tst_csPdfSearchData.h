@@ -0,0 +1,130 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef TST_CSPDFSEARCHDATA_H
+#define TST_CSPDFSEARCHDATA_H
+
+#include <QtCore/QStringList>
+
+#include <csPDFium/csPDFiumText.h>
+#include <csPDFium/csPDFiumUtil.h>
+
+#include <csPDFSearch/csPdfSearchUtil.h>
+
+////// Reference /////////////////////////////////////////////////////////////
+
+// NOTE: The per-word loops the matchers replaced; the expected results.
+namespace ref {
+
+  inline bool matchAt(const QStringList& hay, const QStringList& needles,
+                      const int i, const Qt::CaseSensitivity cs)
+  {
+    if( needles.size() == 1 ) {
+      return hay[i].contains(needles.front(), cs);
+    }
+
+    if( !hay[i].endsWith(needles.front(), cs) ) {
+      return false;
+    }
+    for(int j = 1; j < needles.size()-1; j++) {
+      if( hay[i+j].compare(needles[j], cs) != 0 ) {
+        return false;
+      }
+    }
+
+    return hay[i+needles.size()-1].startsWith(needles.back(), cs);
+  }
+
+  inline csPdfFindResults findAll(const QStringList& hay, const QStringList& needles,
+                                  const Qt::CaseSensitivity cs)
+  {
+    csPdfFindResults results;
+    for(int i = 0; i <= hay.size()-needles.size(); i++) {
+      if( matchAt(hay, needles, i, cs) ) {
+        results.push_back(i);
+      }
+    }
+
+    return results;
+  }
+
+} // namespace ref
+
+////// Data //////////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  inline QStringList page(const int no)
+  {
+    switch( no ) {
+    case 0:
+      return QString::fromUtf8("The quick brown fox jumps over the lazy dog; "
+                               "THE QUICK BROWN FOX. Quickly, the foxes ran.")
+          .split(QLatin1Char(' '));
+    case 1:
+      return QString::fromUtf8("Über den Äpfeln über den Bäumen: über-den "
+                               "Wolken, ÜBER DEN ÄPFELN; übrigens.")
+          .split(QLatin1Char(' '));
+    default:
+      break;
+    }
+
+    return QString::fromUtf8("abab abababa ab aba b ba bab abab ab")
+        .split(QLatin1Char(' '));
+  }
+
+  static const int PAGE_COUNT = 3;
+
+  inline csPDFiumTexts texts(const QStringList& words)
+  {
+    csPDFiumTexts result;
+    for(int i = 0; i < words.size(); i++) {
+      result.push_back(csPDFiumText(QRectF(i, 0, 1, 1), words[i], i));
+    }
+
+    return result;
+  }
+
+  inline QStringList queries()
+  {
+    return QStringList()
+        << _L1("o") << _L1("the") << _L1("QUICK") << _L1("fox")
+        << _L1("quick brown") << _L1("the quick brown fox") << _L1("e lazy d")
+        << _L1("fox. quick") << _L1("x") << _L1("dog; the")
+        << QString::fromUtf8("über") << QString::fromUtf8("den äpfeln")
+        << QString::fromUtf8("r den ä") << QString::fromUtf8("übrigens.")
+        << _L1("ab") << _L1("aba") << _L1("abab") << _L1("b ab")
+        << _L1("ba bab") << _L1("a b ba b") << _L1("ab ab");
+  }
+
+} // namespace priv
+
+#endif // TST_CSPDFSEARCHDATA_H
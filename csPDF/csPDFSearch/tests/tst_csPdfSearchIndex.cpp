@@ -0,0 +1,115 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+#include <csPDFSearch/csPdfSearchIndex.h>
+
+#include "internal/csPdfSearchIndexImpl.h"
+
+#include "tst_csPdfSearchData.h"
+
+////// Test //////////////////////////////////////////////////////////////////
+
+class tst_csPdfSearchIndex : public QObject {
+  Q_OBJECT
+private slots:
+  void initTestCase();
+  void find_data();
+  void find();
+
+private:
+  QTemporaryDir _dir;
+  csPdfSearchIndex _index;
+};
+
+void tst_csPdfSearchIndex::initTestCase()
+{
+  QVERIFY(_dir.isValid());
+
+  csPdfSearchIndexBuilder builder(priv::PAGE_COUNT);
+  for(int no = priv::PAGE_COUNT-1; no >= 0; no--) {
+    builder.addPage(no, priv::texts(priv::page(no)));
+  }
+  QVERIFY(builder.isComplete());
+
+  const QByteArray key(CSPDF_INDEX_KEYSIZE, 'k');
+  const QString filename = csPdfSearchIndex::indexFileName(_dir.path(), key);
+  QVERIFY(builder.write(filename, key));
+
+  _index = csPdfSearchIndex::open(filename, key);
+  QCOMPARE(_index.pageCount(), priv::PAGE_COUNT);
+  for(int no = 0; no < priv::PAGE_COUNT; no++) {
+    QCOMPARE(_index.words(no), priv::page(no));
+  }
+}
+
+void tst_csPdfSearchIndex::find_data()
+{
+  QTest::addColumn<QString>("query");
+  QTest::addColumn<bool>("insensitive");
+
+  foreach(const QString& q, priv::queries()) {
+    const QByteArray name = q.toUtf8();
+    QTest::newRow((name + " (cs)").constData()) << q << false;
+    QTest::newRow((name + " (ci)").constData()) << q << true;
+  }
+}
+
+void tst_csPdfSearchIndex::find()
+{
+  QFETCH(QString, query);
+  QFETCH(bool, insensitive);
+
+  const Qt::CaseSensitivity cs = insensitive
+      ? Qt::CaseInsensitive
+      : Qt::CaseSensitive;
+  const QStringList needles = csPdfPrepareSearch(query);
+
+  QList<QPair<int,int> > expected;
+  for(int no = 0; no < priv::PAGE_COUNT; no++) {
+    foreach(const int word, ref::findAll(priv::page(no), needles, cs)) {
+      expected.push_back(qMakePair(no, word));
+    }
+  }
+
+  QList<QPair<int,int> > found;
+  foreach(const csPdfSearchResult& r, _index.find(needles, cs)) {
+    QCOMPARE(r.span(), needles.size());
+    found.push_back(qMakePair(r.page(), r.index()));
+  }
+  QCOMPARE(found, expected);
+}
+
+QTEST_APPLESS_MAIN(tst_csPdfSearchIndex)
+
+#include "tst_csPdfSearchIndex.moc"
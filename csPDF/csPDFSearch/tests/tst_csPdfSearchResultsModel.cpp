@@ -0,0 +1,164 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <algorithm>
+
+#include <QtTest/QtTest>
+
+#include <csPDFSearch/csPdfSearchResultsModel.h>
+
+typedef QList<csPdfSearchResults> Batches;
+
+Q_DECLARE_METATYPE(Batches)
+
+////// Data //////////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  typedef QList<QVector<int> > Keys; // (Page, Index, Pattern)
+
+  static Keys keys(const csPdfSearchResults& results)
+  {
+    Keys result;
+    foreach(const csPdfSearchResult& r, results) {
+      result.push_back(QVector<int>() << r.page() << r.index() << r.pattern());
+    }
+
+    return result;
+  }
+
+  static csPdfSearchResults batch(const int first, const int step, const int count,
+                                  const int pattern = 0)
+  {
+    csPdfSearchResults result;
+    for(int i = 0; i < count; i++) {
+      const int no = first + i*step;
+      result.push_back(csPdfSearchResult(no/4, no%4, 1, pattern));
+    }
+
+    return result;
+  }
+
+  // NOTE: Deterministic, i.e. failures are reproducible.
+  static Batches random(const int numBatches, const int batchSize)
+  {
+    uint seed = 4711;
+    Batches result;
+    for(int i = 0; i < numBatches; i++) {
+      csPdfSearchResults b;
+      for(int j = 0; j < batchSize; j++) {
+        seed = seed*1103515245u + 12345u;
+        const int r = int((seed >> 8) % 4096);
+        b.push_back(csPdfSearchResult(r/64, r%16, 1, (r/16)%4));
+      }
+      result.push_back(b);
+    }
+
+    return result;
+  }
+
+} // namespace priv
+
+////// Test //////////////////////////////////////////////////////////////////
+
+class tst_csPdfSearchResultsModel : public QObject {
+  Q_OBJECT
+private slots:
+  void insertResults_data();
+  void insertResults();
+};
+
+void tst_csPdfSearchResultsModel::insertResults_data()
+{
+  QTest::addColumn<Batches>("batches");
+
+  csPdfSearchResults reversed = priv::batch(0, 1, 20);
+  std::reverse(reversed.begin(), reversed.end());
+
+  QTest::newRow("single")
+      << (Batches() << priv::batch(0, 1, 20));
+  QTest::newRow("appended")
+      << (Batches() << priv::batch(0, 1, 10) << priv::batch(10, 1, 10));
+  QTest::newRow("prepended")
+      << (Batches() << priv::batch(10, 1, 10) << priv::batch(0, 1, 10));
+  QTest::newRow("interleaved")
+      << (Batches() << priv::batch(0, 2, 10) << priv::batch(1, 2, 10));
+  QTest::newRow("interleaved runs")
+      << (Batches() << priv::batch(0, 1, 5) << priv::batch(20, 1, 5)
+          << priv::batch(5, 3, 5) << priv::batch(6, 3, 5));
+  QTest::newRow("duplicates")
+      << (Batches() << priv::batch(0, 1, 10) << priv::batch(0, 1, 10)
+          << priv::batch(5, 1, 10));
+  QTest::newRow("patterns")
+      << (Batches() << priv::batch(0, 1, 10, 1) << priv::batch(0, 1, 10, 0)
+          << priv::batch(0, 2, 5, 2));
+  QTest::newRow("out of order")
+      << (Batches() << reversed << priv::batch(40, -3, 10));
+  QTest::newRow("empty")
+      << (Batches() << csPdfSearchResults() << priv::batch(0, 1, 5)
+          << csPdfSearchResults());
+  QTest::newRow("random")
+      << priv::random(16, 32);
+}
+
+void tst_csPdfSearchResultsModel::insertResults()
+{
+  QFETCH(Batches, batches);
+
+  csPdfSearchResults expected;
+  foreach(const csPdfSearchResults& b, batches) {
+    expected += b;
+  }
+  std::stable_sort(expected.begin(), expected.end());
+
+  csPdfSearchResultsModel model;
+  QSignalSpy spy(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+  foreach(const csPdfSearchResults& b, batches) {
+    model.insertResults(b);
+  }
+
+  int inserted = 0;
+  foreach(const QList<QVariant>& args, spy) {
+    inserted += args[2].toInt() - args[1].toInt() + 1;
+  }
+  QCOMPARE(inserted, expected.size());
+  QCOMPARE(model.rowCount(), expected.size());
+
+  csPdfSearchResults rows;
+  for(int row = 0; row < model.rowCount(); row++) {
+    rows.push_back(model.result(row));
+  }
+  QCOMPARE(priv::keys(rows), priv::keys(expected));
+}
+
+QTEST_APPLESS_MAIN(tst_csPdfSearchResultsModel)
+
+#include "tst_csPdfSearchResultsModel.moc"
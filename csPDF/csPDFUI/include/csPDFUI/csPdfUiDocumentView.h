@@ -32,21 +32,34 @@
 #ifndef CSPDFUIDOCUMENTVIEW_H
 #define CSPDFUIDOCUMENTVIEW_H
 
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QStack>
+#include <QtCore/QVector>
 #include <QtWidgets/QGraphicsView>
 
 #include <csPDFUI/cspdfui_config.h>
 #include <csPDFium/csPDFiumDocument.h>
 
+class csPdfUiPageItem;
+class csPdfUiPrefetcher;
+class csPdfUiTileCache;
+
 struct csPdfUiDocumentViewConfig {
   csPdfUiDocumentViewConfig()
     : maxKeyBounces(1)
     , maxWheelBounces(1)
+    , maxTileCacheSize(128)
+    , prefetchPages(2)
+    , maxPrefetchSize(32)
   {
   }
 
   int maxKeyBounces;
   int maxWheelBounces;
+  int maxTileCacheSize; // [MB]
+  int prefetchPages;    // Ahead in reading direction; 0 == Off
+  int maxPrefetchSize;  // [MB]
 };
 
 class  CS_PDFUI_EXPORT csPdfUiDocumentView : public QGraphicsView {
@@ -68,6 +81,11 @@ public:
     UserLayer      = 1000
   };
 
+  enum LayoutMode {
+    SinglePage = 0,
+    Continuous
+  };
+
   csPdfUiDocumentView(QWidget *parent);
   ~csPdfUiDocumentView();
 
@@ -78,6 +96,8 @@ public:
 
   const csPDFiumPage& page() const;
 
+  int layoutMode() const;
+
   static void setItemId(QGraphicsItem *item, const int id);
   static int itemId(const QGraphicsItem *item);
 
@@ -91,6 +111,8 @@ public:
 
 public slots:
   void gotoDestination(const csPDFiumDest& dest);
+  // NOTE: Rectangles of the current page in page coordinates.
+  void highlightRects(const QList<QRectF>& rects);
   void highlightText(const QString& text);
   void removeMarks();
   void reverseHistory();
@@ -99,6 +121,7 @@ public slots:
   void showNextPage();
   virtual void showPage(int no, bool updateHistory); // [1, _doc.pageCount()]
   void showPreviousPage();
+  void setLayoutMode(int mode);
   void setZoom(qreal level); // [%]
   void setZoomBestFit();
   void setZoomFitToPageWidth();
@@ -114,14 +137,23 @@ protected:
   void wheelEvent(QWheelEvent *event);
 
 private slots:
+  void pageLoaded(int no);
+  void requestTiles();
   void selectArea(QRect rect, QPointF fromScene, QPointF toScene);
+  void updateVisiblePages();
 
 private:
   bool followLink(const QPointF& scenePos);
   bool isBottomTouched() const;
   bool isTopTouched() const;
   bool isVScrollRequired() const;
+  void clearPageItems();
+  void layoutPages();
+  QPointF pageOffset() const;
+  int pageAt(const qreal y) const;
+  void prefetchPages();
   void renderPage();
+  void setCurrentPage(const int no);
   bool setZoom(const qreal level, const int newMode);
 
 protected:
@@ -152,6 +184,15 @@ private:
   int _keyBounces;
   int _wheelBounces;
   QStack<PageHistory> _history; // [1, _doc.pageCount()]
+  csPdfUiTileCache *_tileCache;
+  csPdfUiPrefetcher *_prefetcher;
+  int _direction; // Reading direction: 1 == Forward, -1 == Backward
+  int _layoutMode;
+  QVector<QRectF> _layout; // Continuous: Scene rectangle of every page
+  QHash<int,csPdfUiPageItem*> _pageItems; // Continuous: Materialized pages
+  QList<csPdfUiPageItem*> _itemPool; // Continuous: Recycled, off the scene
+  int _current;   // Continuous: Current page; 0-based, possibly loading
+  int _requested; // Continuous: Page being shown by showPage(), else -1
   static csPdfUiDocumentViewConfig _cfg;
 
 signals:
@@ -36,6 +36,7 @@
 
 #include <csPDFUI/cspdfui_config.h>
 #include <csPDFium/csPDFiumDocument.h>
+#include <csPDFSearch/csPdfSearchResult.h>
 
 namespace Ui {
   class csPdfUiSearchWidget;
@@ -48,6 +49,8 @@ public:
   ~csPdfUiSearchWidget();
 
   void setDocument(const csPDFiumDocument& doc);
+  // NOTE: Opt-in; cf. csPdfSearch::setIndexDirectory().
+  void setIndexDirectory(const QString& dir);
 
 public slots:
   void cancel();
@@ -58,12 +61,14 @@ public slots:
 
 private slots:
   void activateResult(const QModelIndex& index);
+  void finishSearch();
+  void insertResults(const csPdfSearchResults& results);
 
 protected:
   bool event(QEvent *event);
 
 signals:
-  void highlightRequested(const QString& text);
+  void highlightRequested(const QList<QRectF>& rects); // Of the requested page
   void pageRequested(int no, bool history = true);
 
 private:
@@ -76,6 +81,7 @@ private:
   class csPdfSearch *_search;
   class QThread *_thread;
   int _startIndex;
+  bool _canceling; // Results of a canceled search are dropped
 };
 
 #endif // CSPDFUISEARCHWIDGET_H
@@ -0,0 +1,145 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFUIPAGEITEM_H
+#define CSPDFUIPAGEITEM_H
+
+#include <QtCore/QCache>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtGui/QImage>
+#include <QtWidgets/QGraphicsObject>
+
+#include <csPDFium/csPDFiumDocument.h>
+#include <csPDFium/csPDFiumPage.h>
+
+////// Tile Cache ////////////////////////////////////////////////////////////
+
+struct csPdfUiTileKey {
+  csPdfUiTileKey(const int _page = -1, const int _zoom = 0,
+                 const int _col = 0, const int _row = 0)
+    : page(_page)
+    , zoom(_zoom)
+    , col(_col)
+    , row(_row)
+  {
+  }
+
+  inline bool operator==(const csPdfUiTileKey& other) const
+  {
+    return
+        page == other.page  &&  zoom == other.zoom  &&
+        col  == other.col   &&  row  == other.row;
+  }
+
+  int page; // 0-based
+  int zoom; // [%]
+  int col;
+  int row;
+};
+
+inline uint qHash(const csPdfUiTileKey& key, uint seed = 0)
+{
+  return qHash(key.page, seed) ^ qHash(key.zoom << 20 | key.row << 10 | key.col, seed);
+}
+
+// NOTE: The cost of a tile is its size in KiB.
+class csPdfUiTileCache : public QCache<csPdfUiTileKey,QImage> {
+public:
+  csPdfUiTileCache(const int maxSizeMB)
+    : QCache<csPdfUiTileKey,QImage>(maxSizeMB*1024)
+  {
+  }
+};
+
+////// Page Item /////////////////////////////////////////////////////////////
+
+class csPdfUiPageItem : public QGraphicsObject {
+  Q_OBJECT
+public:
+  csPdfUiPageItem(const csPDFiumPage& page, csPdfUiTileCache *cache,
+                  QGraphicsItem *parent = nullptr);
+  // NOTE: A blank placeholder until a page is loaded; cf. loadPage().
+  csPdfUiPageItem(csPdfUiTileCache *cache, QGraphicsItem *parent = nullptr);
+  ~csPdfUiPageItem();
+
+  int number() const; // 0-based; known while loading, too
+  const csPDFiumPage& page() const; // Empty while loading
+
+  // NOTE: Loads the page on csPDFium::renderThreadPool(); the item shows a
+  //       blank page of 'size' until pageLoaded() is emitted.
+  void loadPage(const csPDFiumDocument& doc, const int no, const QSizeF& size);
+  // NOTE: Cancels all requests & releases the page, e.g. to recycle the item.
+  void reset();
+
+  qreal renderScale() const;
+  void setRenderScale(const qreal scale);
+
+  QRectF boundingRect() const;
+  void paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+             QWidget *widget);
+
+  // NOTE: Driven by the view upon zoom, scroll & resize; never by paint().
+  //       'exposed' is given in item coordinates.
+  void requestTiles(const QRectF& exposed);
+
+  static int tileSize();
+
+signals:
+  void pageLoaded(int no);
+
+private slots:
+  void showPage();
+  void showPreview();
+  void showTile();
+
+private:
+  void cancelStale();
+  void initialize();
+  QRect pixelRect() const;
+  void requestTile(const csPdfUiTileKey& key, const int priority);
+  void setPage(const csPDFiumPage& page);
+  QRectF tileRect(const csPdfUiTileKey& key) const;
+
+  // NOTE: Number & size are cached to not contend with the render threads.
+  csPDFiumPage _page;
+  int _no;
+  QSizeF _size;
+  csPdfUiTileCache *_cache;
+  int _zoom; // [%]
+  QHash<csPdfUiTileKey,QFutureWatcher<QImage>*> _pending;
+  QHash<csPdfUiTileKey,int> _failed; // Failed attempts at the current zoom
+  QImage _preview;
+  QFutureWatcher<QImage> *_previewWatcher;
+  QFutureWatcher<csPDFiumPage> *_pageWatcher;
+};
+
+#endif // CSPDFUIPAGEITEM_H
@@ -0,0 +1,83 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFUIPREFETCHER_H
+#define CSPDFUIPREFETCHER_H
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+
+#include <csPDFium/csPDFiumDocument.h>
+
+#include "internal/csPdfUiPageItem.h"
+
+class csPdfUiPrefetcher : public QObject {
+  Q_OBJECT
+public:
+  csPdfUiPrefetcher(csPdfUiTileCache *cache, QObject *parent = nullptr);
+  ~csPdfUiPrefetcher();
+
+  void clear();
+
+  // NOTE: Returns an empty page unless 'no' was prefetched.
+  csPDFiumPage page(const int no) const;
+
+  // NOTE: Prefetches 'count' pages ahead of 'current' in 'direction' and one
+  //       behind; the tiles landed on by a page flip are rendered at 'zoom'.
+  //       'maxBytes' bounds the prefetched pages & the tiles in flight, across
+  //       calls; rendered tiles are accounted by the tile cache.
+  void prefetch(const csPDFiumDocument& doc, const int current, const int direction,
+                const int zoom, const QSize& viewport,
+                const int count, const int maxBytes);
+
+private slots:
+  void storePage();
+  void storeTile();
+
+private:
+  void cancelPages(const QList<int>& keep);
+  void cancelTiles(const QList<int>& keep);
+  void removePages(const QList<int>& keep);
+  void requestTiles(const csPDFiumPage& page);
+
+  csPdfUiTileCache *_cache;
+  int _current;
+  int _zoom; // [%]
+  QSize _viewport;
+  int _maxBytes; // [Byte]
+  int _bytes;    // [Byte] Outstanding, i.e. pages held or pending & tiles pending
+  QHash<int,csPDFiumPage> _pages;
+  QHash<int,QFutureWatcher<csPDFiumPage>*> _pendingPages;
+  QHash<csPdfUiTileKey,QFutureWatcher<QImage>*> _pendingTiles;
+};
+
+#endif // CSPDFUIPREFETCHER_H
@@ -43,6 +43,9 @@
 #include <csPDFium/csPDFiumUtil.h>
 #include <csPDFSearch/csPdfSearchUtil.h>
 
+#include "internal/csPdfUiPageItem.h"
+#include "internal/csPdfUiPrefetcher.h"
+
 ////// Macros ////////////////////////////////////////////////////////////////
 
 // Item Data
@@ -60,6 +63,10 @@
 
 #define _SCALE  (_zoom/100.0)
 
+// Layout
+
+#define PAGE_SPACING  10.0 // Continuous: Vertical gap between pages
+
 ////// Private ///////////////////////////////////////////////////////////////
 
 namespace priv {
@@ -89,11 +96,12 @@ namespace priv {
     return item;
   }
 
-  static QGraphicsItem *addSelection(QGraphicsScene *scene, const csPDFiumText& pdfText)
+  static QGraphicsItem *addSelection(QGraphicsScene *scene, const csPDFiumText& pdfText,
+                                     const QPointF& offset = QPointF())
   {
     QColor selColor(Qt::blue);
     selColor.setAlphaF(0.4);
-    QGraphicsItem *item = scene->addRect(pdfText.rect(),
+    QGraphicsItem *item = scene->addRect(pdfText.rect().translated(offset),
                                          QPen(Qt::NoPen),
                                          QBrush(selColor, Qt::SolidPattern));
     item->setZValue(csPdfUiDocumentView::SelectionLayer);
@@ -122,6 +130,15 @@ csPdfUiDocumentView::csPdfUiDocumentView(QWidget *parent)
   , _keyBounces(0)
   , _wheelBounces(0)
   , _history()
+  , _tileCache(nullptr)
+  , _prefetcher(nullptr)
+  , _direction(1)
+  , _layoutMode(SinglePage)
+  , _layout()
+  , _pageItems()
+  , _itemPool()
+  , _current(-1)
+  , _requested(-1)
 {
   qRegisterMetaType<csPDFiumDest>("csPDFiumDest");
 
@@ -139,14 +156,36 @@ csPdfUiDocumentView::csPdfUiDocumentView(QWidget *parent)
 
   _scene->installEventFilter(this);
 
+  // Tile Cache //////////////////////////////////////////////////////////////
+
+  _tileCache = new csPdfUiTileCache(_cfg.maxTileCacheSize);
+
+  // Prefetcher //////////////////////////////////////////////////////////////
+
+  _prefetcher = new csPdfUiPrefetcher(_tileCache, this);
+
   // Signals & Slots /////////////////////////////////////////////////////////
 
   connect(this, &csPdfUiDocumentView::rubberBandChanged,
           this, &csPdfUiDocumentView::selectArea);
+  connect(horizontalScrollBar(), &QScrollBar::valueChanged,
+          this, &csPdfUiDocumentView::updateVisiblePages);
+  connect(verticalScrollBar(), &QScrollBar::valueChanged,
+          this, &csPdfUiDocumentView::updateVisiblePages);
+  // NOTE: Connected last; the visible pages are materialized by then.
+  connect(horizontalScrollBar(), &QScrollBar::valueChanged,
+          this, &csPdfUiDocumentView::requestTiles);
+  connect(verticalScrollBar(), &QScrollBar::valueChanged,
+          this, &csPdfUiDocumentView::requestTiles);
 }
 
 csPdfUiDocumentView::~csPdfUiDocumentView()
 {
+  // NOTE: Page items & prefetcher refer to the tile cache!
+  _scene->clear();
+  clearPageItems();
+  _prefetcher->clear();
+  delete _tileCache;
 }
 
 QString csPdfUiDocumentView::selectedText() const
@@ -188,9 +227,15 @@ const csPDFiumDocument& csPdfUiDocumentView::document() const
 void csPdfUiDocumentView::setDocument(const csPDFiumDocument& doc)
 {
   _scene->clear();
+  clearPageItems();
+  _prefetcher->clear();
   _doc.clear();
   _page.clear();
   _history.clear();
+  _direction = 1;
+
+  _tileCache->clear();
+  _tileCache->setMaxCost(_cfg.maxTileCacheSize*1024);
 
   _doc = doc;
 
@@ -198,6 +243,8 @@ void csPdfUiDocumentView::setDocument(const csPDFiumDocument& doc)
   _zoom = ZOOM_INIT;
   emit zoomChanged(_zoom);
 
+  layoutPages();
+
   showFirstPage();
 }
 
@@ -206,6 +253,11 @@ const csPDFiumPage& csPdfUiDocumentView::page() const
   return _page;
 }
 
+int csPdfUiDocumentView::layoutMode() const
+{
+  return _layoutMode;
+}
+
 void csPdfUiDocumentView::setItemId(QGraphicsItem *item, const int id)
 {
   item->setData(DATA_ID, id);
@@ -251,10 +303,21 @@ void csPdfUiDocumentView::gotoDestination(const csPDFiumDest& dest)
 
   if(        dest.type() == csPDFiumDest::Goto ) {
     showPage(dest.pageIndex+1, true);
+    // NOTE: Continuous: The page may still be loading; a link is followed
+    //       upon request, hence loading it here is acceptable.
+    const csPDFiumPage page = !_page.isEmpty()  &&  _page.number() == dest.pageIndex
+        ? _page
+        : _doc.page(dest.pageIndex);
+    const QPointF offset = _layoutMode == Continuous  &&  dest.pageIndex < _layout.size()
+        ? _layout[dest.pageIndex].topLeft()
+        : QPointF();
+    if( page.isEmpty() ) {
+      return;
+    }
     if( dest.focusPosPage.isNull() ) {
-      centerOn(_page.rect().center().x(), _page.rect().top());
+      centerOn(page.rect().center().x() + offset.x(), page.rect().top() + offset.y());
     } else {
-      centerOn(_page.mapToScene(dest.focusPosPage));
+      centerOn(page.mapToScene(dest.focusPosPage) + offset);
     }
   } else if( dest.type() == csPDFiumDest::RemoteGoto ) {
     if( !dest.srcFilename.isEmpty()  &&  !dest.destFilename.isEmpty() ) {
@@ -263,6 +326,20 @@ void csPdfUiDocumentView::gotoDestination(const csPDFiumDest& dest)
   }
 }
 
+void csPdfUiDocumentView::highlightRects(const QList<QRectF>& rects)
+{
+  removeItems(HighlightId);
+
+  if( _page.isEmpty() ) {
+    return;
+  }
+
+  const QPointF offset = pageOffset();
+  foreach(const QRectF& rect, rects) {
+    priv::addHighlight(_scene, rect.translated(offset));
+  }
+}
+
 void csPdfUiDocumentView::highlightText(const QString& text)
 {
   removeItems(HighlightId);
@@ -271,12 +348,13 @@ void csPdfUiDocumentView::highlightText(const QString& text)
     return;
   }
 
+  const QPointF offset = pageOffset();
   const csPDFiumTexts texts = _page.texts();
   const QStringList needles = csPdfPrepareSearch(text);
   if( needles.size() == 1 ) {
     foreach(const int pos,
             csPdfFindAll(texts, needles.front(), Qt::CaseInsensitive)) {
-      priv::addHighlight(_scene, texts[pos].rect());
+      priv::addHighlight(_scene, texts[pos].rect().translated(offset));
     }
   } else if( needles.size() > 1 ) {
     QList<QRectF> hlBoxes;
@@ -289,7 +367,7 @@ void csPdfUiDocumentView::highlightText(const QString& text)
       }
     }
     foreach(const QRectF hlBox, hlBoxes) {
-      priv::addHighlight(_scene, hlBox);
+      priv::addHighlight(_scene, hlBox.translated(offset));
     }
   }
 }
@@ -326,11 +404,14 @@ void csPdfUiDocumentView::showNextPage()
     return;
   }
 
-  const int oldNo = _page.number();
+  // NOTE: Continuous: The current page may still be loading.
+  const int oldNo = _layoutMode == Continuous  &&  _current >= 0
+      ? _current
+      : _page.number();
   const int newNo = qBound(0, oldNo+1, _doc.pageCount()-1);
   showPage(newNo+1, false);
 
-  if( oldNo != newNo ) {
+  if( oldNo != newNo  &&  _layoutMode == SinglePage ) {
     centerOn(_scene->sceneRect().center().x(), _scene->sceneRect().top());
   }
 }
@@ -354,10 +435,32 @@ void csPdfUiDocumentView::showPage(int no, bool updateHistory)
     return;
   }
 
-  _scene->clear();
-
   const int pageNo = qBound(0, no-1, _doc.pageCount()-1); // 0-based
-  _page = _doc.page(pageNo);
+  if( !_page.isEmpty()  &&  _page.number() != pageNo ) {
+    _direction = pageNo > _page.number()
+        ?  1
+        : -1;
+  }
+
+  if( _layoutMode == Continuous ) {
+    // NOTE: Align the page's top with the viewport's top; the page becomes
+    //       current, even if the scroll range keeps it off the center.
+    _requested = pageNo;
+    if( pageNo < _layout.size() ) {
+      const QRectF rect = _layout[pageNo];
+      centerOn(rect.center().x(), rect.top() + viewport()->height()/_SCALE/2.0);
+    }
+    updateVisiblePages();
+    requestTiles();
+    _requested = -1;
+    return;
+  }
+
+  _scene->clear();
+  _page = _prefetcher->page(pageNo);
+  if( _page.isEmpty() ) {
+    _page = _doc.page(pageNo);
+  }
   setZoom(_zoom, _zoomMode);
   renderPage();
 
@@ -377,15 +480,43 @@ void csPdfUiDocumentView::showPreviousPage()
     return;
   }
 
-  const int oldNo = _page.number();
+  // NOTE: Continuous: The current page may still be loading.
+  const int oldNo = _layoutMode == Continuous  &&  _current >= 0
+      ? _current
+      : _page.number();
   const int newNo = qBound(0, oldNo-1, _doc.pageCount()-1);
   showPage(newNo+1, false);
 
-  if( oldNo != newNo ) {
+  if( oldNo != newNo  &&  _layoutMode == SinglePage ) {
     centerOn(_scene->sceneRect().center().x(), _scene->sceneRect().bottom());
   }
 }
 
+void csPdfUiDocumentView::setLayoutMode(int mode)
+{
+  if( mode != SinglePage  &&  mode != Continuous ) {
+    return;
+  }
+
+  if( mode == _layoutMode ) {
+    return;
+  }
+
+  const int no = _page.isEmpty()
+      ? 1
+      : _page.number()+1;
+
+  _scene->clear();
+  clearPageItems();
+  _prefetcher->clear();
+  _page.clear();
+
+  _layoutMode = mode;
+  layoutPages();
+
+  showPage(no, false);
+}
+
 void csPdfUiDocumentView::setZoom(qreal level)
 {
   if( setZoom(level, ZoomUser) ) {
@@ -545,6 +676,9 @@ void csPdfUiDocumentView::resizeEvent(QResizeEvent *event)
   }
 
   QGraphicsView::resizeEvent(event);
+
+  updateVisiblePages();
+  requestTiles();
 }
 
 void csPdfUiDocumentView::wheelEvent(QWheelEvent *event)
@@ -619,6 +753,42 @@ void csPdfUiDocumentView::wheelEvent(QWheelEvent *event)
 
 ////// private slots /////////////////////////////////////////////////////////
 
+void csPdfUiDocumentView::pageLoaded(int no)
+{
+  csPdfUiPageItem *item = _pageItems.value(no, nullptr);
+  if( item == nullptr  ||  item->page().isEmpty() ) {
+    return;
+  }
+
+  foreach(const csPDFiumLink link, item->page().links()) {
+    if( !link.isEmpty() ) {
+      priv::addLink(_scene, link)->setParentItem(item);
+    }
+  }
+
+  const QRectF view = mapToScene(viewport()->rect()).boundingRect();
+  item->requestTiles(item->mapFromScene(view).boundingRect());
+
+  if( no == _current ) {
+    setCurrentPage(no);
+  }
+}
+
+void csPdfUiDocumentView::requestTiles()
+{
+  const QRectF view = mapToScene(viewport()->rect()).boundingRect();
+  foreach(QGraphicsItem *found, _scene->items(view)) {
+    if( itemId(found) != PageId ) {
+      continue;
+    }
+
+    csPdfUiPageItem *item = dynamic_cast<csPdfUiPageItem*>(found);
+    if( item != nullptr ) {
+      item->requestTiles(item->mapFromScene(view).boundingRect());
+    }
+  }
+}
+
 void csPdfUiDocumentView::selectArea(QRect rect, QPointF fromScene, QPointF toScene)
 {
   if( _page.isEmpty()  ||  rect.isEmpty() ) {
@@ -630,14 +800,88 @@ void csPdfUiDocumentView::selectArea(QRect rect, QPointF fromScene, QPointF toSc
   const qreal w = qAbs(fromScene.x() - toScene.x());
   const qreal h = qAbs(fromScene.y() - toScene.y());
 
+  // NOTE: Continuous: Select on the page the selection starts on.
+  csPDFiumPage page = _page;
+  QPointF offset = pageOffset();
+  if( _layoutMode == Continuous ) {
+    const int no = pageAt(y);
+    if( _pageItems.contains(no) ) {
+      page = _pageItems[no]->page();
+      offset = _layout[no].topLeft();
+    }
+  }
+
   removeItems(SelectionId);
-  foreach(const csPDFiumText t, _page.texts(QRectF(x, y, w, h))) {
-    priv::addSelection(_scene, t);
+  foreach(const csPDFiumText t, page.texts(QRectF(x, y, w, h).translated(-offset))) {
+    priv::addSelection(_scene, t, offset);
   }
 }
 
+void csPdfUiDocumentView::updateVisiblePages()
+{
+  if( _layoutMode != Continuous  ||  _layout.isEmpty() ) {
+    return;
+  }
+
+  const QRectF view = mapToScene(viewport()->rect()).boundingRect();
+  const int first = pageAt(view.top()    - view.height());
+  const int  last = pageAt(view.bottom() + view.height());
+
+  // Recycle Offscreen Pages /////////////////////////////////////////////////
+
+  foreach(const int no, _pageItems.keys()) {
+    if( no < first  ||  no > last ) {
+      csPdfUiPageItem *item = _pageItems.take(no);
+      qDeleteAll(item->childItems()); // NOTE: The page's links.
+      _scene->removeItem(item);
+      item->reset();
+      _itemPool.push_back(item);
+    }
+  }
+
+  // Materialize Visible Pages; NOTE: Pages are loaded off the GUI thread! ///
+
+  for(int no = first; no <= last; no++) {
+    if( _pageItems.contains(no) ) {
+      continue;
+    }
+
+    csPdfUiPageItem *item = nullptr;
+    if( _itemPool.isEmpty() ) {
+      item = new csPdfUiPageItem(_tileCache);
+      item->setZValue(PageLayer);
+      setItemId(item, PageId);
+      connect(item, &csPdfUiPageItem::pageLoaded,
+              this, &csPdfUiDocumentView::pageLoaded);
+    } else {
+      item = _itemPool.takeLast();
+    }
+    item->setPos(_layout[no].topLeft());
+    item->setRenderScale(_SCALE);
+    item->loadPage(_doc, no, _layout[no].size());
+    _scene->addItem(item);
+
+    _pageItems.insert(no, item);
+  }
+
+  // Current Page ////////////////////////////////////////////////////////////
+
+  setCurrentPage(_requested >= 0
+                 ? _requested
+                 : pageAt(view.center().y()));
+}
+
 ////// private ///////////////////////////////////////////////////////////////
 
+void csPdfUiDocumentView::clearPageItems()
+{
+  // NOTE: Materialized pages are deleted along with the scene.
+  _pageItems.clear();
+  qDeleteAll(_itemPool);
+  _itemPool.clear();
+  _current = -1;
+}
+
 bool csPdfUiDocumentView::followLink(const QPointF& scenePos)
 {
   foreach (QGraphicsItem *item, _scene->items(scenePos)) {
@@ -677,21 +921,126 @@ bool csPdfUiDocumentView::isVScrollRequired() const
   return height > viewport()->height();
 }
 
+void csPdfUiDocumentView::layoutPages()
+{
+  _layout.clear();
+  if( _layoutMode != Continuous  ||  _doc.isEmpty() ) {
+    return;
+  }
+
+  const int count = _doc.pageCount();
+  _layout.reserve(count);
+
+  qreal y = 0;
+  qreal width = 0;
+  for(int no = 0; no < count; no++) {
+    const QSizeF size = _doc.pageSize(no);
+    _layout.push_back(QRectF(QPointF(0, y), size));
+    y += size.height() + PAGE_SPACING;
+    width = qMax(width, size.width());
+  }
+
+  for(int no = 0; no < count; no++) {
+    _layout[no].moveLeft((width - _layout[no].width())/2.0);
+  }
+
+  setSceneRect(0, 0, width, qMax<qreal>(0, y - PAGE_SPACING));
+}
+
+QPointF csPdfUiDocumentView::pageOffset() const
+{
+  if( _layoutMode != Continuous  ||  _page.isEmpty()  ||
+      _page.number() >= _layout.size() ) {
+    return QPointF();
+  }
+
+  return _layout[_page.number()].topLeft();
+}
+
+int csPdfUiDocumentView::pageAt(const qreal y) const
+{
+  // NOTE: Binary search; a gap belongs to the page above it.
+  int lo = 0;
+  int hi = _layout.size()-1;
+  while( lo < hi ) {
+    const int mid = (lo + hi)/2;
+    if( _layout[mid].bottom() + PAGE_SPACING < y ) {
+      lo = mid+1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+void csPdfUiDocumentView::prefetchPages()
+{
+  if( _layoutMode != SinglePage  ||  _cfg.prefetchPages < 1  ||  _page.isEmpty() ) {
+    _prefetcher->clear();
+    return;
+  }
+
+  _prefetcher->prefetch(_doc, _page.number(), _direction,
+                        qRound(_zoom), viewport()->size(),
+                        _cfg.prefetchPages, _cfg.maxPrefetchSize*1024*1024);
+}
+
 void csPdfUiDocumentView::renderPage()
 {
-  removeItems(PageId);
+  if( _layoutMode == Continuous ) {
+    foreach(csPdfUiPageItem *item, _pageItems) {
+      item->setRenderScale(_SCALE);
+    }
+    updateVisiblePages();
+    requestTiles();
+    return;
+  }
 
   if( _page.isEmpty() ) {
+    removeItems(PageId);
     return;
   }
 
-  const QImage image = _page.renderToImage(_SCALE);
-  QGraphicsItem *item = _scene->addPixmap(QPixmap::fromImage(image));
-  item->setTransform(QTransform::fromScale(1.0/_SCALE, 1.0/_SCALE));
-  item->setZValue(PageLayer);
-  setItemId(item, PageId);
-
   setSceneRect(_page.rect());
+
+  csPdfUiPageItem *item = nullptr;
+  foreach(QGraphicsItem *found, listItems(PageId)) {
+    item = dynamic_cast<csPdfUiPageItem*>(found);
+    if( item != nullptr  &&  item->page().number() == _page.number() ) {
+      break;
+    }
+    item = nullptr;
+  }
+
+  if( item == nullptr ) {
+    removeItems(PageId);
+    item = new csPdfUiPageItem(_page, _tileCache);
+    item->setZValue(PageLayer);
+    setItemId(item, PageId);
+    _scene->addItem(item);
+  }
+
+  // NOTE: Only the tiles exposed at the new zoom level are rendered.
+  item->setRenderScale(_SCALE);
+  requestTiles();
+
+  prefetchPages();
+}
+
+void csPdfUiDocumentView::setCurrentPage(const int no)
+{
+  _current = no;
+
+  // NOTE: Announced once, when the page is available.
+  const csPdfUiPageItem *item = _pageItems.value(no, nullptr);
+  if( item == nullptr  ||  item->page().isEmpty()  ||
+      (!_page.isEmpty()  &&  _page.number() == no) ) {
+    return;
+  }
+
+  _page = item->page();
+  emit pageChanged(no+1);
 }
 
 bool csPdfUiDocumentView::setZoom(const qreal level, const int newMode)
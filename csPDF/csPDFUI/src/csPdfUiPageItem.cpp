@@ -0,0 +1,407 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <QtGui/QPainter>
+#include <QtWidgets/QStyleOptionGraphicsItem>
+
+#include "internal/csPdfUiPageItem.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+#define TILE_SIZE     256
+#define TILE_RETRIES    2
+#define PREVIEW_SIZE  512
+
+// Render Priorities
+#define PRIORITY_MARGIN   1
+#define PRIORITY_VISIBLE  2
+#define PRIORITY_PREVIEW  3
+#define PRIORITY_PAGE     4
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  struct TileDistance {
+    TileDistance(const QPoint& _center)
+      : center(_center)
+    {
+    }
+
+    inline int distance(const csPdfUiTileKey& key) const
+    {
+      const QPoint d = QPoint(key.col*TILE_SIZE + TILE_SIZE/2,
+                              key.row*TILE_SIZE + TILE_SIZE/2) - center;
+      return d.manhattanLength();
+    }
+
+    inline bool operator()(const csPdfUiTileKey& a, const csPdfUiTileKey& b) const
+    {
+      return distance(a) < distance(b);
+    }
+
+    QPoint center;
+  };
+
+  inline QRect toPixels(const QRectF& rect, const qreal scale)
+  {
+    return QRectF(rect.topLeft()*scale, rect.size()*scale).toAlignedRect();
+  }
+
+} // namespace priv
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPdfUiPageItem::csPdfUiPageItem(const csPDFiumPage& page, csPdfUiTileCache *cache,
+                                 QGraphicsItem *parent)
+  : QGraphicsObject(parent)
+  , _page()
+  , _no(page.number())
+  , _size(page.size())
+  , _cache(cache)
+  , _zoom(0)
+  , _pending()
+  , _failed()
+  , _preview()
+  , _previewWatcher(nullptr)
+  , _pageWatcher(nullptr)
+{
+  initialize();
+  setPage(page);
+}
+
+csPdfUiPageItem::csPdfUiPageItem(csPdfUiTileCache *cache, QGraphicsItem *parent)
+  : QGraphicsObject(parent)
+  , _page()
+  , _no(-1)
+  , _size()
+  , _cache(cache)
+  , _zoom(0)
+  , _pending()
+  , _failed()
+  , _preview()
+  , _previewWatcher(nullptr)
+  , _pageWatcher(nullptr)
+{
+  initialize();
+}
+
+csPdfUiPageItem::~csPdfUiPageItem()
+{
+  _pageWatcher->cancel();
+  _previewWatcher->cancel();
+  foreach(QFutureWatcher<QImage> *watcher, _pending) {
+    watcher->cancel();
+  }
+}
+
+int csPdfUiPageItem::number() const
+{
+  return _no;
+}
+
+const csPDFiumPage& csPdfUiPageItem::page() const
+{
+  return _page;
+}
+
+void csPdfUiPageItem::loadPage(const csPDFiumDocument& doc, const int no, const QSizeF& size)
+{
+  reset();
+
+  prepareGeometryChange();
+  _no   = no;
+  _size = size;
+
+  // NOTE: Replacing the future discards a pending result of the previous one.
+  _pageWatcher->setFuture(doc.pageAsync(no, PRIORITY_PAGE));
+}
+
+void csPdfUiPageItem::reset()
+{
+  _pageWatcher->cancel();
+  _previewWatcher->cancel();
+  foreach(QFutureWatcher<QImage> *watcher, _pending) {
+    watcher->disconnect(this);
+    watcher->cancel();
+    watcher->deleteLater();
+  }
+  _pending.clear();
+  _failed.clear();
+  _preview = QImage();
+  _page.clear();
+
+  update();
+}
+
+qreal csPdfUiPageItem::renderScale() const
+{
+  return _zoom/100.0;
+}
+
+void csPdfUiPageItem::setRenderScale(const qreal scale)
+{
+  const int zoom = qRound(scale*100.0);
+  if( zoom == _zoom ) {
+    return;
+  }
+
+  _zoom = zoom;
+  _failed.clear();
+  cancelStale();
+  update();
+}
+
+QRectF csPdfUiPageItem::boundingRect() const
+{
+  return QRectF(QPointF(0, 0), _size);
+}
+
+void csPdfUiPageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
+                            QWidget * /*widget*/)
+{
+  const QRectF exposed = option->exposedRect & boundingRect();
+  if( exposed.isEmpty() ) {
+    return;
+  }
+
+  painter->fillRect(exposed, Qt::white);
+
+  if( _page.isEmpty()  ||  _cache == nullptr  ||  _zoom < 1 ) {
+    return;
+  }
+
+  const QRect pixels = priv::toPixels(exposed, renderScale()) & pixelRect();
+  if( pixels.isEmpty() ) {
+    return;
+  }
+
+  const qreal previewScale = _preview.isNull()
+      ? 0.0
+      : _preview.width() / boundingRect().width();
+
+  for(int row = pixels.top()/TILE_SIZE; row <= pixels.bottom()/TILE_SIZE; row++) {
+    for(int col = pixels.left()/TILE_SIZE; col <= pixels.right()/TILE_SIZE; col++) {
+      const csPdfUiTileKey key(_no, _zoom, col, row);
+      const QRectF target = tileRect(key);
+
+      const QImage *tile = _cache->object(key);
+      if(        tile != nullptr ) {
+        painter->drawImage(target, *tile);
+      } else if( !_preview.isNull() ) {
+        painter->drawImage(target, _preview,
+                           QRectF(target.topLeft()*previewScale,
+                                  target.size()*previewScale));
+      }
+    }
+  }
+}
+
+void csPdfUiPageItem::requestTiles(const QRectF& exposed)
+{
+  if( _page.isEmpty()  ||  _cache == nullptr  ||  _zoom < 1 ) {
+    return;
+  }
+
+  const QRect visible = priv::toPixels(exposed & boundingRect(), renderScale()) & pixelRect();
+  const QRect  margin = visible.adjusted(-TILE_SIZE, -TILE_SIZE,
+                                         TILE_SIZE, TILE_SIZE) & pixelRect();
+  if( visible.isEmpty() ) {
+    return;
+  }
+
+  QList<csPdfUiTileKey> visibleKeys;
+  QList<csPdfUiTileKey>  marginKeys;
+  for(int row = margin.top()/TILE_SIZE; row <= margin.bottom()/TILE_SIZE; row++) {
+    for(int col = margin.left()/TILE_SIZE; col <= margin.right()/TILE_SIZE; col++) {
+      const csPdfUiTileKey key(_no, _zoom, col, row);
+      if( _cache->contains(key)  ||  _pending.contains(key)  ||
+          _failed.value(key) >= TILE_RETRIES ) {
+        continue;
+      }
+
+      const QRect tile(col*TILE_SIZE, row*TILE_SIZE, TILE_SIZE, TILE_SIZE);
+      if( tile.intersects(visible) ) {
+        visibleKeys.push_back(key);
+      } else {
+        marginKeys.push_back(key);
+      }
+    }
+  }
+
+  // NOTE: Requests of equal priority are served in order of submission.
+  qSort(visibleKeys.begin(), visibleKeys.end(), priv::TileDistance(visible.center()));
+  foreach(const csPdfUiTileKey& key, visibleKeys) {
+    requestTile(key, PRIORITY_VISIBLE);
+  }
+  foreach(const csPdfUiTileKey& key, marginKeys) {
+    requestTile(key, PRIORITY_MARGIN);
+  }
+}
+
+int csPdfUiPageItem::tileSize()
+{
+  return TILE_SIZE;
+}
+
+////// private slots /////////////////////////////////////////////////////////
+
+void csPdfUiPageItem::showPage()
+{
+  const QFuture<csPDFiumPage> future = _pageWatcher->future();
+  if( future.isCanceled()  ||  future.resultCount() < 1 ) {
+    return;
+  }
+
+  setPage(future.result());
+  update();
+
+  emit pageLoaded(_no);
+}
+
+void csPdfUiPageItem::showPreview()
+{
+  const QFuture<QImage> future = _previewWatcher->future();
+  if( future.isCanceled()  ||  future.resultCount() < 1 ) {
+    return;
+  }
+
+  _preview = future.result();
+  update();
+}
+
+void csPdfUiPageItem::showTile()
+{
+  QFutureWatcher<QImage> *watcher =
+      dynamic_cast<QFutureWatcher<QImage>*>(sender());
+  if( watcher == nullptr ) {
+    return;
+  }
+
+  const csPdfUiTileKey key = _pending.key(watcher);
+  _pending.remove(key);
+  watcher->deleteLater();
+
+  const QFuture<QImage> future = watcher->future();
+  if( future.isCanceled()  ||  _cache == nullptr ) {
+    return;
+  }
+
+  // NOTE: A failed tile is retried upon the next request, but not forever.
+  const QImage image = future.resultCount() > 0
+      ? future.result()
+      : QImage();
+  if( image.isNull() ) {
+    if( key.zoom == _zoom ) {
+      _failed[key]++;
+    }
+    return;
+  }
+
+  _failed.remove(key);
+  _cache->insert(key, new QImage(image), qMax(1, image.byteCount()/1024));
+  if( key.zoom == _zoom ) {
+    update(tileRect(key));
+  }
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void csPdfUiPageItem::cancelStale()
+{
+  QMutableHashIterator<csPdfUiTileKey,QFutureWatcher<QImage>*> iter(_pending);
+  while( iter.hasNext() ) {
+    iter.next();
+    if( iter.key().zoom == _zoom ) {
+      continue;
+    }
+
+    QFutureWatcher<QImage> *watcher = iter.value();
+    watcher->disconnect(this);
+    watcher->cancel();
+    watcher->deleteLater();
+    iter.remove();
+  }
+}
+
+void csPdfUiPageItem::initialize()
+{
+  setFlag(ItemUsesExtendedStyleOption, true);
+
+  _pageWatcher = new QFutureWatcher<csPDFiumPage>(this);
+  connect(_pageWatcher, &QFutureWatcher<csPDFiumPage>::finished,
+          this, &csPdfUiPageItem::showPage);
+
+  _previewWatcher = new QFutureWatcher<QImage>(this);
+  connect(_previewWatcher, &QFutureWatcher<QImage>::finished,
+          this, &csPdfUiPageItem::showPreview);
+}
+
+QRect csPdfUiPageItem::pixelRect() const
+{
+  const QSizeF size = _size*renderScale();
+  return QRect(0, 0, size.width(), size.height());
+}
+
+void csPdfUiPageItem::requestTile(const csPdfUiTileKey& key, const int priority)
+{
+  const QRect tile(key.col*TILE_SIZE, key.row*TILE_SIZE, TILE_SIZE, TILE_SIZE);
+
+  QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+  connect(watcher, &QFutureWatcher<QImage>::finished,
+          this, &csPdfUiPageItem::showTile);
+  watcher->setFuture(_page.renderTileAsync(tile, key.zoom/100.0, priority));
+
+  _pending.insert(key, watcher);
+}
+
+void csPdfUiPageItem::setPage(const csPDFiumPage& page)
+{
+  _page = page;
+  if( _page.isEmpty() ) {
+    return;
+  }
+
+  // NOTE: A low resolution preview is shown until the tiles arrive.
+  const qreal scale = PREVIEW_SIZE / qMax(_size.width(), _size.height());
+  _previewWatcher->setFuture(_page.renderAsync(scale, PRIORITY_PREVIEW));
+}
+
+QRectF csPdfUiPageItem::tileRect(const csPdfUiTileKey& key) const
+{
+  const qreal scale = key.zoom/100.0;
+  const QSizeF size = _size*scale;
+  const QRect pixels = QRect(key.col*TILE_SIZE, key.row*TILE_SIZE, TILE_SIZE, TILE_SIZE)
+      & QRect(0, 0, size.width(), size.height());
+
+  return QRectF(pixels.x()/scale, pixels.y()/scale,
+                pixels.width()/scale, pixels.height()/scale);
+}
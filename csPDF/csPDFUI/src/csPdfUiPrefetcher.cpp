@@ -0,0 +1,285 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "internal/csPdfUiPrefetcher.h"
+
+////// Macros ////////////////////////////////////////////////////////////////
+
+// NOTE: Below any request of the page items.
+#define PRIORITY_PREFETCH  0
+
+#define TILE_BYTES  (csPdfUiPageItem::tileSize()*csPdfUiPageItem::tileSize()*4)
+
+// NOTE: Estimate of a parsed page; its objects are not exposed by csPDFium.
+#define PAGE_BYTES  (64*1024)
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPdfUiPrefetcher::csPdfUiPrefetcher(csPdfUiTileCache *cache, QObject *parent)
+  : QObject(parent)
+  , _cache(cache)
+  , _current(-1)
+  , _zoom(0)
+  , _viewport()
+  , _maxBytes(0)
+  , _bytes(0)
+  , _pages()
+  , _pendingPages()
+  , _pendingTiles()
+{
+}
+
+csPdfUiPrefetcher::~csPdfUiPrefetcher()
+{
+  clear();
+}
+
+void csPdfUiPrefetcher::clear()
+{
+  cancelPages(QList<int>());
+  cancelTiles(QList<int>());
+  removePages(QList<int>());
+  _current = -1;
+}
+
+csPDFiumPage csPdfUiPrefetcher::page(const int no) const
+{
+  return _pages.value(no);
+}
+
+void csPdfUiPrefetcher::prefetch(const csPDFiumDocument& doc, const int current,
+                                 const int direction,
+                                 const int zoom, const QSize& viewport,
+                                 const int count, const int maxBytes)
+{
+  if( doc.isEmpty()  ||  _cache == nullptr ) {
+    clear();
+    return;
+  }
+
+  const int step = direction < 0
+      ? -1
+      :  1;
+
+  QList<int> wanted;
+  for(int i = 1; i <= count; i++) {
+    wanted.push_back(current + i*step);
+  }
+  wanted.push_back(current - step);
+
+  const int pageCount = doc.pageCount();
+  for(int i = wanted.size()-1; i >= 0; i--) {
+    if( wanted[i] < 0  ||  wanted[i] >= pageCount ) {
+      wanted.removeAt(i);
+    }
+  }
+
+  // NOTE: The current page is kept; the view may still refer to it.
+  QList<int> keep = wanted;
+  keep.push_back(current);
+
+  if( zoom != _zoom  ||  viewport != _viewport ) {
+    cancelTiles(QList<int>());
+  } else {
+    cancelTiles(keep);
+  }
+  cancelPages(keep);
+  removePages(keep);
+
+  _current  = current;
+  _zoom     = zoom;
+  _viewport = viewport;
+  _maxBytes = qMax(0, maxBytes);
+
+  foreach(const int no, wanted) {
+    if(        _pages.contains(no) ) {
+      requestTiles(_pages[no]);
+    } else if( !_pendingPages.contains(no) ) {
+      if( _bytes + PAGE_BYTES > _maxBytes ) {
+        continue;
+      }
+      _bytes += PAGE_BYTES;
+
+      QFutureWatcher<csPDFiumPage> *watcher = new QFutureWatcher<csPDFiumPage>(this);
+      connect(watcher, &QFutureWatcher<csPDFiumPage>::finished,
+              this, &csPdfUiPrefetcher::storePage);
+      watcher->setFuture(doc.pageAsync(no, PRIORITY_PREFETCH));
+      _pendingPages.insert(no, watcher);
+    }
+  }
+}
+
+////// private slots /////////////////////////////////////////////////////////
+
+void csPdfUiPrefetcher::storePage()
+{
+  QFutureWatcher<csPDFiumPage> *watcher =
+      dynamic_cast<QFutureWatcher<csPDFiumPage>*>(sender());
+  if( watcher == nullptr ) {
+    return;
+  }
+
+  _pendingPages.remove(_pendingPages.key(watcher));
+  watcher->deleteLater();
+
+  const QFuture<csPDFiumPage> future = watcher->future();
+  const csPDFiumPage page = future.isCanceled()  ||  future.resultCount() < 1
+      ? csPDFiumPage()
+      : future.result();
+  if( page.isEmpty() ) {
+    _bytes -= PAGE_BYTES;
+    return;
+  }
+
+  _pages.insert(page.number(), page);
+  requestTiles(page);
+}
+
+void csPdfUiPrefetcher::storeTile()
+{
+  QFutureWatcher<QImage> *watcher =
+      dynamic_cast<QFutureWatcher<QImage>*>(sender());
+  if( watcher == nullptr ) {
+    return;
+  }
+
+  const csPdfUiTileKey key = _pendingTiles.key(watcher);
+  _pendingTiles.remove(key);
+  watcher->deleteLater();
+  _bytes -= TILE_BYTES;
+
+  const QFuture<QImage> future = watcher->future();
+  if( future.isCanceled()  ||  future.resultCount() < 1 ) {
+    return;
+  }
+
+  const QImage image = future.result();
+  if( !image.isNull()  &&  !_cache->contains(key) ) {
+    _cache->insert(key, new QImage(image), qMax(1, image.byteCount()/1024));
+  }
+}
+
+////// private ///////////////////////////////////////////////////////////////
+
+void csPdfUiPrefetcher::cancelPages(const QList<int>& keep)
+{
+  QMutableHashIterator<int,QFutureWatcher<csPDFiumPage>*> iter(_pendingPages);
+  while( iter.hasNext() ) {
+    iter.next();
+    if( keep.contains(iter.key()) ) {
+      continue;
+    }
+
+    QFutureWatcher<csPDFiumPage> *watcher = iter.value();
+    watcher->disconnect(this);
+    watcher->cancel();
+    watcher->deleteLater();
+    iter.remove();
+    _bytes -= PAGE_BYTES;
+  }
+}
+
+void csPdfUiPrefetcher::cancelTiles(const QList<int>& keep)
+{
+  QMutableHashIterator<csPdfUiTileKey,QFutureWatcher<QImage>*> iter(_pendingTiles);
+  while( iter.hasNext() ) {
+    iter.next();
+    if( keep.contains(iter.key().page) ) {
+      continue;
+    }
+
+    QFutureWatcher<QImage> *watcher = iter.value();
+    watcher->disconnect(this);
+    watcher->cancel();
+    watcher->deleteLater();
+    iter.remove();
+    _bytes -= TILE_BYTES;
+  }
+}
+
+void csPdfUiPrefetcher::removePages(const QList<int>& keep)
+{
+  QMutableHashIterator<int,csPDFiumPage> iter(_pages);
+  while( iter.hasNext() ) {
+    iter.next();
+    if( keep.contains(iter.key()) ) {
+      continue;
+    }
+
+    iter.remove();
+    _bytes -= PAGE_BYTES;
+  }
+}
+
+void csPdfUiPrefetcher::requestTiles(const csPDFiumPage& page)
+{
+  const int T = csPdfUiPageItem::tileSize();
+  if( page.isEmpty()  ||  _zoom < 1  ||  _viewport.isEmpty()  ||
+      _bytes + TILE_BYTES > _maxBytes ) {
+    return;
+  }
+
+  // NOTE: Flipping forward lands on the page's top, backward on its bottom.
+  const QSizeF size = page.size()*(_zoom/100.0);
+  const QRect pixels(0, 0, size.width(), size.height());
+  QRect landing(QPoint(0, 0), _viewport);
+  landing.moveCenter(pixels.center());
+  if( page.number() > _current ) {
+    landing.moveTop(0);
+  } else {
+    landing.moveBottom(pixels.bottom());
+  }
+  landing &= pixels;
+  if( landing.isEmpty() ) {
+    return;
+  }
+
+  for(int row = landing.top()/T; row <= landing.bottom()/T; row++) {
+    for(int col = landing.left()/T; col <= landing.right()/T; col++) {
+      const csPdfUiTileKey key(page.number(), _zoom, col, row);
+      if( _cache->contains(key)  ||  _pendingTiles.contains(key) ) {
+        continue;
+      }
+
+      if( _bytes + TILE_BYTES > _maxBytes ) {
+        return;
+      }
+      _bytes += TILE_BYTES;
+
+      QFutureWatcher<QImage> *watcher = new QFutureWatcher<QImage>(this);
+      connect(watcher, &QFutureWatcher<QImage>::finished,
+              this, &csPdfUiPrefetcher::storeTile);
+      watcher->setFuture(page.renderTileAsync(QRect(col*T, row*T, T, T),
+                                              _zoom/100.0, PRIORITY_PREFETCH));
+      _pendingTiles.insert(key, watcher);
+    }
+  }
+}
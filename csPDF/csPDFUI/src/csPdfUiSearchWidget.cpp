@@ -37,6 +37,7 @@
 
 #include <csPDFSearch/csPdfSearch.h>
 #include <csPDFSearch/csPdfSearchResultsModel.h>
+#include <csPDFSearch/csPdfSearchTextCache.h>
 #include <csPDFSearch/csPdfSearchUtil.h>
 #include <csPDFium/csPDFiumUtil.h>
 #include <csQt/csHighlightingDelegate.h>
@@ -57,6 +58,7 @@ csPdfUiSearchWidget::csPdfUiSearchWidget(QWidget *parent, Qt::WindowFlags f)
   , _search(nullptr)
   , _thread(nullptr)
   , _startIndex()
+  , _canceling(false)
 {
   qRegisterMetaType<csPdfSearchResults>("csPdfSearchResults");
 
@@ -88,16 +90,21 @@ csPdfUiSearchWidget::csPdfUiSearchWidget(QWidget *parent, Qt::WindowFlags f)
   _search  = new csPdfSearch();
   _search->moveToThread(_thread);
 
-  connect(_search, &csPdfSearch::finished, this, &csPdfUiSearchWidget::cancel);
-  connect(_search, &csPdfSearch::found,
-          _results, &csPdfSearchResultsModel::insertResults);
+  connect(_search, &csPdfSearch::canceled, this, &csPdfUiSearchWidget::finishSearch);
+  connect(_search, &csPdfSearch::finished, this, &csPdfUiSearchWidget::finishSearch);
+  connect(_search, &csPdfSearch::found, this, &csPdfUiSearchWidget::insertResults);
   connect(_search, &csPdfSearch::processed,
           ui->progressBar, &QProgressBar::setValue);
+
+  _thread->start();
 }
 
 csPdfUiSearchWidget::~csPdfUiSearchWidget()
 {
-  cancel();
+  // NOTE: The search's destructor waits for its workers to finish.
+  _search->cancel();
+  _thread->quit();
+  _thread->wait();
   delete _search;
   delete ui;
 }
@@ -107,26 +114,24 @@ void csPdfUiSearchWidget::setDocument(const csPDFiumDocument& doc)
   cancel();
   clear();
   _doc = doc;
+  _results->setTextCache(csPdfSearchTextCache(_doc), 2);
   _startIndex = 0;
 }
 
+void csPdfUiSearchWidget::setIndexDirectory(const QString& dir)
+{
+  _search->setIndexDirectory(dir);
+}
+
 ////// public slots //////////////////////////////////////////////////////////
 
 void csPdfUiSearchWidget::cancel()
 {
-  if( !_thread->isRunning() ) {
-    return;
+  // NOTE: The UI is reset upon csPdfSearch::canceled(); cf. finishSearch().
+  if( _search->isRunning() ) {
+    _canceling = true;
+    _search->cancel();
   }
-
-  _search->cancel();
-  while( _search->isRunning() );
-  _thread->quit();
-  _thread->wait();
-
-  ui->startButton->setVisible(true);
-  ui->cancelButton->setVisible(false);
-  ui->searchEdit->setVisible(true);
-  ui->progressBar->setVisible(false);
 }
 
 void csPdfUiSearchWidget::clear()
@@ -147,7 +152,7 @@ void csPdfUiSearchWidget::setStartPage(int no)
 
 void csPdfUiSearchWidget::start()
 {
-  if( _thread->isRunning() ) {
+  if( _search->isRunning()  ||  _canceling ) {
     return;
   }
 
@@ -163,8 +168,7 @@ void csPdfUiSearchWidget::start()
   clear();
   _delegate->setSubstring(ui->searchEdit->text());
 
-  _thread->start();
-  _search->start(_doc, needles, _startIndex, Qt::MatchWrap, 2);
+  _search->start(_doc, needles, _startIndex, Qt::MatchWrap);
 }
 
 ////// private slots /////////////////////////////////////////////////////////
@@ -175,11 +179,29 @@ void csPdfUiSearchWidget::activateResult(const QModelIndex& index)
     return;
   }
 
-  const QModelIndex pageIndex = _results->index(index.row(), 0);
-  const int pageNo = _results->data(pageIndex, Qt::DisplayRole).toInt();
-  if( pageNo > 0 ) {
-    emit pageRequested(pageNo); // 1-based!
-    emit highlightRequested(ui->searchEdit->text());
+  // NOTE: The hit's words are known; no need to search the page again.
+  const csPdfSearchResult result = _results->result(index.row());
+  if( !result.isEmpty() ) {
+    emit pageRequested(result.page()+1); // 1-based!
+    emit highlightRequested(_results->textCache().rects(result));
+  }
+}
+
+void csPdfUiSearchWidget::finishSearch()
+{
+  _canceling = false;
+
+  ui->startButton->setVisible(true);
+  ui->cancelButton->setVisible(false);
+  ui->searchEdit->setVisible(true);
+  ui->progressBar->setVisible(false);
+}
+
+void csPdfUiSearchWidget::insertResults(const csPdfSearchResults& results)
+{
+  // NOTE: Queued before csPdfSearch::canceled(); possibly of another document.
+  if( !_canceling ) {
+    _results->insertResults(results);
   }
 }
 
@@ -36,6 +36,8 @@
 
 #include <csPDFium/cspdfium_config.h>
 
+class QThreadPool;
+
 namespace csPDFium {
 
   CS_PDFIUM_EXPORT extern const qreal DPI;
@@ -51,6 +53,12 @@ namespace csPDFium {
 
   CS_PDFIUM_EXPORT void destroy();
 
+  // NOTE: Dedicated pool serving csPDFiumPage::renderAsync().
+  CS_PDFIUM_EXPORT QThreadPool *renderThreadPool();
+
+  // NOTE: Dedicated pool serving csPDFiumDocument::textPagesAsync().
+  CS_PDFIUM_EXPORT QThreadPool *textThreadPool();
+
 } // namespace csPDFium
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(csPDFium::PathExtractionFlags)
@@ -0,0 +1,63 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMBITMAPPOOL_H
+#define CSPDFIUMBITMAPPOOL_H
+
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtGui/QImage>
+
+#include <csPDFium/cspdfium_config.h>
+
+class CS_PDFIUM_EXPORT csPDFiumBitmapPool {
+public:
+  csPDFiumBitmapPool(const int maxBitmaps = 8);
+  ~csPDFiumBitmapPool();
+
+  void clear();
+  int count() const;
+  int maxBitmaps() const;
+
+  // NOTE: Returns a recycled image if one matches 'size' & 'format'.
+  QImage acquire(const QSize& size, const QImage::Format format);
+  // NOTE: Images still shared with other QImage instances are not recycled.
+  void release(QImage& image);
+
+private:
+  Q_DISABLE_COPY(csPDFiumBitmapPool)
+
+  mutable QMutex _mutex;
+  QList<QImage> _bitmaps;
+  int _maxBitmaps;
+};
+
+#endif // CSPDFIUMBITMAPPOOL_H
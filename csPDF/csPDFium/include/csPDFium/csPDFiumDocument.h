@@ -32,10 +32,13 @@
 #ifndef CSPDFIUMDOCUMENT_H
 #define CSPDFIUMDOCUMENT_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QList>
 #include <QtCore/QPair>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtGui/QMatrix>
 
 #include <csPDFium/cspdfium_config.h>
 #include <csPDFium/csPDFiumContentsNode.h>
@@ -46,6 +49,28 @@
 typedef QPair<int,QStringList>   csPDFiumWordsPage;
 typedef QList<csPDFiumWordsPage> csPDFiumWordsPages;
 
+struct csPDFiumPageGeometry {
+  csPDFiumPageGeometry()
+    : size()
+    , rotation(0)
+    , ctm()
+    , exact(false)
+  {
+  }
+
+  inline bool isValid() const
+  {
+    return !size.isEmpty();
+  }
+
+  QSizeF  size;     // Rotated, i.e. as displayed
+  int     rotation; // Clockwise in quarter turns: [0, 3]
+  QMatrix ctm;      // PDF user space to page coordinates
+  bool    exact;    // Otherwise 'size' only; cf. csPDFiumPage
+};
+
+typedef QVector<csPDFiumPageGeometry> csPDFiumPageGeometries;
+
 class csPDFiumDocumentImpl;
 
 class CS_PDFIUM_EXPORT csPDFiumDocument {
@@ -59,13 +84,29 @@ public:
   QString fileName() const;
   int pageCount() const;
   csPDFiumPage page(const int no) const; // no == [0, pageCount()-1]
+  // NOTE: Loads (i.e. parses) the page on csPDFium::renderThreadPool().
+  QFuture<csPDFiumPage> pageAsync(const int no, const int priority = 0) const;
+  // NOTE: Page geometries are gathered once at load time; no locking involved.
+  QSizeF pageSize(const int no) const; // no == [0, pageCount()-1]
+  csPDFiumPageGeometry pageGeometry(const int no) const; // no == [0, pageCount()-1]
+  csPDFiumPageGeometries pageGeometries() const;
   csPDFiumContentsNode *tableOfContents() const;
   csPDFiumTextPage textPage(const int no) const; // no == [0, pageCount()-1]
+  // NOTE: Holds ALL pages in memory; cf. csPDFiumTextPageIterator.
   csPDFiumTextPages textPages(const int first, const int count = -1) const;
+  // NOTE: One worker on csPDFium::textThreadPool(); results are indexed by
+  //       page, i.e. resultAt(i) == textPage(first+i). PDFium's text
+  //       extraction is serialized library-wide; cf. load().
+  QFuture<csPDFiumTextPage> textPagesAsync(const int first, const int count = -1) const;
   csPDFiumDest resolveBookmark(const void *pointer) const;
   csPDFiumDest resolveLink(const void *pointer) const;
   csPDFiumWordsPages wordsPages(const int firstIndex, const int count = -1) const;
 
+  // NOTE: Limits apply to the document's cache of parsed pages.
+  void setPageCacheLimits(const int maxPages, const int maxSizeMB);
+
+  // NOTE: PDFium's font state is process-wide, hence page loading, rendering
+  //       & text extraction are serialized across ALL documents.
   static csPDFiumDocument load(const QString& filename,
                                const bool memory = false,
                                const QByteArray& password = QByteArray(),
@@ -73,8 +114,11 @@ public:
 
 private:
   csPDFiumDest createDest(const void *_dest, const void *_action) const;
+  csPDFiumTextPage streamTextPage(const int no, QStringList *words) const;
 
   QSharedPointer<csPDFiumDocumentImpl> impl;
+  friend class csPDFiumTextPageIterator;
+  friend class csPDFiumTextTask;
 };
 
 #endif // CSPDFIUMDOCUMENT_H
@@ -32,6 +32,7 @@
 #ifndef CSPDFIUMPAGE_H
 #define CSPDFIUMPAGE_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QRectF>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QSizeF>
@@ -40,8 +41,10 @@
 
 #include <csPDFium/cspdfium_config.h>
 #include <csPDFium/csPDFium.h>
+#include <csPDFium/csPDFiumBitmapPool.h>
 #include <csPDFium/csPDFiumLink.h>
 #include <csPDFium/csPDFiumText.h>
+#include <csPDFium/csPDFiumTextChars.h>
 
 class csPDFiumPageImpl;
 
@@ -55,6 +58,27 @@ public:
   QPointF mapToScene(const QPointF& p) const;
   int number() const;
   QImage renderToImage(const qreal scale = 1.0) const;
+  // NOTE: Higher priority requests are served first; cancel() skips queued requests.
+  QFuture<QImage> renderAsync(const qreal scale = 1.0, const int priority = 0) const;
+  // NOTE: 'tile' is given in pixels of the page rendered at 'scale'.
+  QImage renderTile(const QRect& tile, const qreal scale = 1.0) const;
+  QFuture<QImage> renderTileAsync(const QRect& tile, const qreal scale = 1.0,
+                                  const int priority = 0) const;
+  QImage renderTile(const QRect& tile, const qreal scale,
+                    const QImage::Format format,
+                    csPDFiumBitmapPool *pool = nullptr) const;
+  // NOTE: Renders the window at 'offset' (pixels at 'scale') into the caller's
+  //       buffer. Formats: (A)RGB32 & RGBA/X8888, including premultiplied ones,
+  //       are rendered directly; RGB888 & Grayscale8 are converted.
+  bool renderInto(uchar *data, const QSize& size, const int bytesPerLine,
+                  const QImage::Format format,
+                  const QPoint& offset = QPoint(), const qreal scale = 1.0) const;
+  bool renderInto(QImage& image,
+                  const QPoint& offset = QPoint(), const qreal scale = 1.0) const;
+  // NOTE: 'region' is given in page coordinates, i.e. within rect().
+  QImage renderRegion(const QRectF& region, const qreal scale = 1.0) const;
+  QFuture<QImage> renderRegionAsync(const QRectF& region, const qreal scale = 1.0,
+                                    const int priority = 0) const;
   csPDFiumLinks links() const;
   QRectF rect() const;
   QSizeF size() const;
@@ -62,12 +86,14 @@ public:
   QString text() const;
   csPDFiumTexts texts(const QRectF& area = QRectF()) const;
   QStringList words() const;
+  csPDFiumTextChars textChars() const;
 
   QList<QPainterPath> extractPaths(const csPDFium::PathExtractionFlags flags = 0) const;
 
 private:
   QSharedPointer<csPDFiumPageImpl> impl;
   friend class csPDFiumDocument;
+  friend class csPDFiumProgressiveRenderer;
 };
 
 #endif // CSPDFIUMPAGE_H
@@ -0,0 +1,79 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMPROGRESSIVERENDERER_H
+#define CSPDFIUMPROGRESSIVERENDERER_H
+
+#include <QtCore/QSharedPointer>
+#include <QtGui/QImage>
+
+#include <csPDFium/cspdfium_config.h>
+#include <csPDFium/csPDFiumPage.h>
+
+class csPDFiumProgressiveRendererImpl;
+
+class CS_PDFIUM_EXPORT csPDFiumProgressiveRenderer {
+public:
+  enum Status {
+    Invalid = 0,
+    Ready,
+    Incomplete,
+    Done,
+    Failed,
+    Aborted
+  };
+
+  csPDFiumProgressiveRenderer(const csPDFiumPage& page = csPDFiumPage(),
+                              const qreal scale = 1.0,
+                              const QRect& tile = QRect());
+  ~csPDFiumProgressiveRenderer();
+
+  bool isEmpty() const;
+  void clear();
+  Status status() const;
+  QImage image() const; // Partial unless status() == Done
+
+  // NOTE: Starts or resumes rendering; returns after at most ~budget [ms].
+  //       Only one progressive render per page runs at a time; the others
+  //       stay Ready, i.e. queued, until the page is released.
+  // CAUTION: The page's synchronous renders wait a bounded time for a
+  //          started render to be released, then fail; cf. abort().
+  Status render(const int budget);
+
+  // NOTE: Safe to call from any thread; aborts a running render() & releases
+  //       the page. Blocks until a running slice has returned.
+  void abort();
+
+private:
+  QSharedPointer<csPDFiumProgressiveRendererImpl> impl;
+};
+
+#endif // CSPDFIUMPROGRESSIVERENDERER_H
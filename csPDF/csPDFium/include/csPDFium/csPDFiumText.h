@@ -41,10 +41,11 @@
 class csPDFiumText {
 public:
   csPDFiumText(const QRectF& rect = QRectF(), const QString& text = QString(),
-               const int pos = -1)
-    : _rect(rect)
+               const int pos = -1, const int offset = -1)
+    : _pos(pos)
+    , _offset(offset)
+    , _rect(rect)
     , _text(text)
-    , _pos(pos)
   {
   }
 
@@ -74,8 +75,9 @@ public:
 
   inline void clear()
   {
-    _pos  = -1;
-    _rect = QRectF();
+    _pos    = -1;
+    _offset = -1;
+    _rect   = QRectF();
     _text.clear();
   }
 
@@ -89,6 +91,17 @@ public:
     _pos = pos;
   }
 
+  // NOTE: Offset of the first character into csPDFiumPage::text()
+  inline int offset() const
+  {
+    return _offset;
+  }
+
+  inline void setOffset(const int offset)
+  {
+    _offset = offset;
+  }
+
   inline const QRectF& rect() const
   {
     return _rect;
@@ -112,6 +125,7 @@ public:
 
 private:
   int     _pos;
+  int     _offset;
   QRectF  _rect;
   QString _text;
 };
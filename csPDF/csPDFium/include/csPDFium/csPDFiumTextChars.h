@@ -0,0 +1,98 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMTEXTCHARS_H
+#define CSPDFIUMTEXTCHARS_H
+
+#include <QtCore/QRectF>
+#include <QtCore/QVector>
+
+// NOTE: A page's characters as flat arrays ("structure of arrays");
+//       index i of every array refers to character i of csPDFiumPage::text().
+struct csPDFiumTextChars {
+  enum Flag {
+    Separator = 0x01, // Whitespace; ends a word
+    LineBreak = 0x02,
+    Generated = 0x04  // Inserted by the text extraction
+  };
+
+  csPDFiumTextChars()
+    : unicodes()
+    , boxes()
+    , fontSizes()
+    , flags()
+  {
+  }
+
+  inline int size() const
+  {
+    return unicodes.size();
+  }
+
+  inline bool isEmpty() const
+  {
+    return unicodes.isEmpty();
+  }
+
+  inline void clear()
+  {
+    unicodes.clear();
+    boxes.clear();
+    fontSizes.clear();
+    flags.clear();
+  }
+
+  inline void resize(const int count)
+  {
+    unicodes.resize(count);
+    boxes.resize(4*count);
+    fontSizes.resize(count);
+    flags.resize(count);
+  }
+
+  inline QRectF rect(const int i) const
+  {
+    const float *b = boxes.constData() + 4*i;
+    return QRectF(QPointF(b[0], b[1]), QPointF(b[2], b[3]));
+  }
+
+  inline bool testFlag(const int i, const Flag f) const
+  {
+    return (flags[i] & f) != 0;
+  }
+
+  QVector<uint>   unicodes;
+  QVector<float>  boxes;     // 4 per Character: left, top, right, bottom
+  QVector<float>  fontSizes;
+  QVector<quint8> flags;     // Flag
+};
+
+#endif // CSPDFIUMTEXTCHARS_H
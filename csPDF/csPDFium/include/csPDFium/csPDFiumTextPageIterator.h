@@ -0,0 +1,58 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMTEXTPAGEITERATOR_H
+#define CSPDFIUMTEXTPAGEITERATOR_H
+
+#include <csPDFium/cspdfium_config.h>
+#include <csPDFium/csPDFiumDocument.h>
+
+// NOTE: Yields one page at a time; hence memory is bounded by a single page
+//       regardless of the document's size. Stop calling next() to terminate.
+class CS_PDFIUM_EXPORT csPDFiumTextPageIterator {
+public:
+  csPDFiumTextPageIterator(const csPDFiumDocument& doc = csPDFiumDocument(),
+                           const int first = 0, const int count = -1);
+  ~csPDFiumTextPageIterator();
+
+  bool hasNext() const;
+  int nextPageNo() const;
+  int remaining() const;
+  csPDFiumTextPage next();
+  csPDFiumWordsPage nextWords();
+
+private:
+  csPDFiumDocument _doc;
+  int _next;
+  int _last;
+};
+
+#endif // CSPDFIUMTEXTPAGEITERATOR_H
@@ -32,38 +32,97 @@
 #ifndef CSPDFIUMDOCUMENTIMPL_H
 #define CSPDFIUMDOCUMENTIMPL_H
 
+#include <QtCore/QAtomicInt>
 #include <QtCore/QByteArray>
 #include <QtCore/QMutex>
 #include <QtCore/QMutexLocker>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QString>
 
 #include <fpdfview.h>
+#include <fpdf_edit.h>
+
+#include <csPDFium/csPDFiumDocument.h>
+
+#include "internal/csPDFiumPageCache.h"
 
 #define CSPDFIUM_DOCIMPL() \
   QMutexLocker locker(&(impl->mutex))
 
+class csPDFiumDocumentImpl;
+
+typedef QSharedPointer<csPDFiumDocumentImpl> csPDFiumDocumentImplPtr;
+
 class csPDFiumDocumentImpl {
 public:
   csPDFiumDocumentImpl()
     : data()
     , document(NULL)
     , fileName()
+    , geometry()
     , mutex()
+    , openPages(0)
+    , pages()
   {
   }
 
   ~csPDFiumDocumentImpl()
   {
+    // NOTE: Cached pages need to be closed before their document!
+    pages.clear();
     if( document != NULL ) {
+      CSPDFIUM_GLOBALLOCK();
       FPDF_CloseDocument(document);
       document = NULL;
     }
   }
 
+  // NOTE: Caller must hold 'mutex'!
+  //       cache == false: A miss is NOT cached, i.e. scans don't flush 'pages'.
+  inline csPDFiumPageHandlePtr loadPage(const int no, const bool cache = true)
+  {
+    csPDFiumPageHandlePtr handle = pages.object(no);
+    if( !handle.isNull() ) {
+      return handle;
+    }
+
+    FPDF_PAGE page = NULL;
+    {
+      CSPDFIUM_GLOBALLOCK();
+      page = FPDF_LoadPage(document, no);
+    }
+    if( page == NULL ) {
+      return csPDFiumPageHandlePtr();
+    }
+
+    handle = csPDFiumPageHandlePtr(new csPDFiumPageHandle(page, &openPages));
+    if( !cache ) {
+      return handle;
+    }
+
+    pages.insert(no, handle,
+                 CSPDFIUM_PAGE_BASEBYTES +
+                 qint64(FPDFPage_CountObject(page))*CSPDFIUM_PAGE_OBJECTBYTES);
+
+    return handle;
+  }
+
+  // NOTE: Caller must hold 'mutex'!
+  inline QMatrix pageCTM(const int no, const csPDFiumPageHandlePtr& handle) const
+  {
+    return geometry[no].exact
+        ? geometry[no].ctm
+        : util::getPageCTM(handle->page);
+  }
+
   QByteArray    data;
   FPDF_DOCUMENT document;
   QString       fileName;
+  csPDFiumPageGeometries geometry; // Read-only after load()
   QMutex        mutex;
+  // Page Cache
+  QAtomicInt        openPages;
+  csPDFiumPageCache pages;
 };
 
 #endif // CSPDFIUMDOCUMENTIMPL_H
@@ -0,0 +1,224 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMPAGECACHE_H
+#define CSPDFIUMPAGECACHE_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QStringList>
+#include <QtCore/QWaitCondition>
+
+#include <fpdfview.h>
+
+#include "internal/fpdf_util.h"
+
+#define CSPDFIUM_PAGECACHE_COUNT      8
+#define CSPDFIUM_PAGECACHE_SIZE      64 // [MB]
+// Estimated Memory of a Parsed Page
+#define CSPDFIUM_PAGE_BASEBYTES    4096
+#define CSPDFIUM_PAGE_OBJECTBYTES   512
+// Maximum Wait for a Page's Progressive Render
+#define CSPDFIUM_PROGRESSIVE_WAIT  2000 // [ms]
+
+////// Page Handle ///////////////////////////////////////////////////////////
+
+// NOTE: A parsed page & its derived state; shared by all users of the page.
+class csPDFiumPageHandle {
+public:
+  csPDFiumPageHandle(const FPDF_PAGE _page, QAtomicInt *_openPages)
+    : page(_page)
+    , progressive(nullptr)
+    , progressiveDone()
+    , layer()
+    , openPages(_openPages)
+  {
+    openPages->ref();
+  }
+
+  ~csPDFiumPageHandle()
+  {
+    {
+      CSPDFIUM_GLOBALLOCK();
+      FPDF_ClosePage(page);
+    }
+    page = NULL;
+    openPages->deref();
+  }
+
+  // NOTE: Built on first use; cf. util::extractTextLayer().
+  inline const csPDFiumTextLayer& textLayer(const QMatrix& ctm)
+  {
+    if( !layer.isLoaded ) {
+      util::extractTextLayer(page, ctm, layer);
+    }
+    return layer;
+  }
+
+  // NOTE: PDFium keeps ONE render context per page, which any rendering
+  //       replaces; hence a progressive render owns the page until closed.
+  //       'mutex' is the owning document's mutex, held by the caller.
+  // CAUTION: An owner may never be resumed; hence waits are always bounded!
+  inline bool waitForProgressive(QMutex *mutex,
+                                 const unsigned long time = CSPDFIUM_PROGRESSIVE_WAIT)
+  {
+    while( progressive != nullptr ) {
+      if( !progressiveDone.wait(mutex, time) ) {
+        return progressive == nullptr;
+      }
+    }
+    return true;
+  }
+
+  inline void releaseProgressive(const void *owner)
+  {
+    if( progressive == owner ) {
+      progressive = nullptr;
+      progressiveDone.wakeAll();
+    }
+  }
+
+  FPDF_PAGE page;
+  const void *progressive; // Owner of the page's progressive render context
+  QWaitCondition progressiveDone;
+  csPDFiumTextLayer layer;
+
+private:
+  Q_DISABLE_COPY(csPDFiumPageHandle)
+
+  QAtomicInt *openPages;
+};
+
+typedef QSharedPointer<csPDFiumPageHandle> csPDFiumPageHandlePtr;
+
+////// Page Cache ////////////////////////////////////////////////////////////
+
+// NOTE: LRU; not thread-safe, i.e. guarded by the owning document's mutex.
+class csPDFiumPageCache {
+public:
+  csPDFiumPageCache()
+    : _maxCount(CSPDFIUM_PAGECACHE_COUNT)
+    , _maxBytes(qint64(CSPDFIUM_PAGECACHE_SIZE)*1024*1024)
+    , _bytes(0)
+    , _entries()
+    , _lru()
+  {
+  }
+
+  ~csPDFiumPageCache()
+  {
+  }
+
+  inline void clear()
+  {
+    _entries.clear();
+    _lru.clear();
+    _bytes = 0;
+  }
+
+  inline int count() const
+  {
+    return _entries.size();
+  }
+
+  inline qint64 bytes() const
+  {
+    return _bytes;
+  }
+
+  inline void setLimits(const int maxCount, const qint64 maxBytes)
+  {
+    _maxCount = qMax(0, maxCount);
+    _maxBytes = qMax<qint64>(0, maxBytes);
+    trim();
+  }
+
+  inline csPDFiumPageHandlePtr object(const int no)
+  {
+    if( !_entries.contains(no) ) {
+      return csPDFiumPageHandlePtr();
+    }
+
+    _lru.removeOne(no);
+    _lru.push_front(no);
+
+    return _entries[no].handle;
+  }
+
+  inline void insert(const int no, const csPDFiumPageHandlePtr& handle,
+                     const qint64 bytes)
+  {
+    remove(no);
+
+    Entry entry;
+    entry.handle = handle;
+    entry.bytes  = bytes;
+    _entries.insert(no, entry);
+    _lru.push_front(no);
+    _bytes += bytes;
+
+    trim();
+  }
+
+private:
+  Q_DISABLE_COPY(csPDFiumPageCache)
+
+  struct Entry {
+    csPDFiumPageHandlePtr handle;
+    qint64 bytes;
+  };
+
+  inline void remove(const int no)
+  {
+    if( _entries.contains(no) ) {
+      _bytes -= _entries.take(no).bytes;
+      _lru.removeOne(no);
+    }
+  }
+
+  inline void trim()
+  {
+    while( !_lru.isEmpty()  &&
+           (_entries.size() > _maxCount  ||  _bytes > _maxBytes) ) {
+      remove(_lru.back());
+    }
+  }
+
+  int _maxCount;
+  qint64 _maxBytes;
+  qint64 _bytes;
+  QHash<int,Entry> _entries;
+  QList<int> _lru; // Front == Most Recently Used
+};
+
+#endif // CSPDFIUMPAGECACHE_H
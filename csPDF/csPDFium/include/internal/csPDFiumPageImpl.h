@@ -38,6 +38,7 @@
 #include <csPDFium/csPDFiumText.h>
 
 #include "internal/csPDFiumDocumentImpl.h"
+#include "internal/csPDFiumPageCache.h"
 
 #define CSPDFIUM_PAGEIMPL() \
   QMutexLocker locker(&(impl->doc->mutex))
@@ -49,25 +50,20 @@ public:
     , doc()
     , no(-1)
     , page(NULL)
-    , textCache()
-    , wordCache()
+    , handle()
   {
   }
 
   ~csPDFiumPageImpl()
   {
-    if( !doc.isNull()  &&  page != NULL ) {
-      FPDF_ClosePage(page);
-      page = NULL;
-    }
   }
 
   QMatrix ctm;
-  QSharedPointer<csPDFiumDocumentImpl> doc;
+  csPDFiumDocumentImplPtr doc; // Document owning "page"
   int no;
-  FPDF_PAGE page;
-  csPDFiumTexts textCache;
-  QStringList wordCache;
+  FPDF_PAGE page; // == handle->page
+  // NOTE: Declared after 'doc'; hence the page is closed before its document.
+  csPDFiumPageHandlePtr handle;
 };
 
 #endif // CSPDFIUMPAGEIMPL_H
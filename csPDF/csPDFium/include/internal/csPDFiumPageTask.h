@@ -0,0 +1,80 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMPAGETASK_H
+#define CSPDFIUMPAGETASK_H
+
+#include <QtCore/QFuture>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QRunnable>
+
+#include <csPDFium/csPDFiumDocument.h>
+
+class csPDFiumPageTask : public QRunnable {
+public:
+  csPDFiumPageTask(const csPDFiumDocument& doc, const int no)
+    : _doc(doc)
+    , _no(no)
+    , _result()
+  {
+    setAutoDelete(true);
+    _result.reportStarted();
+  }
+
+  ~csPDFiumPageTask()
+  {
+  }
+
+  inline QFuture<csPDFiumPage> future()
+  {
+    return _result.future();
+  }
+
+  void run()
+  {
+    if( !_result.isCanceled() ) {
+      const csPDFiumPage page = _doc.page(_no);
+      if( !page.isEmpty() ) {
+        _result.reportResult(page);
+      }
+    }
+    _result.reportFinished();
+  }
+
+private:
+  Q_DISABLE_COPY(csPDFiumPageTask)
+
+  csPDFiumDocument _doc;
+  int _no;
+  QFutureInterface<csPDFiumPage> _result;
+};
+
+#endif // CSPDFIUMPAGETASK_H
@@ -0,0 +1,113 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMPROGRESSIVERENDERERIMPL_H
+#define CSPDFIUMPROGRESSIVERENDERERIMPL_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QImage>
+
+#include <fpdf_progressive.h>
+
+#include <csPDFium/csPDFiumProgressiveRenderer.h>
+
+#include "internal/csPDFiumPageImpl.h"
+
+#define CSPDFIUM_RENDERERIMPL() \
+  QMutexLocker locker(&(impl->page->doc->mutex))
+
+class csPDFiumProgressiveRendererImpl {
+public:
+  csPDFiumProgressiveRendererImpl()
+    : abort(0)
+    , bitmap(NULL)
+    , budget(0)
+    , image()
+    , page()
+    , pause()
+    , rect()
+    , size()
+    , status(csPDFiumProgressiveRenderer::Invalid)
+    , timer()
+  {
+    pause.version        = 1;
+    pause.NeedToPauseNow = needToPauseNow;
+    pause.user           = this;
+  }
+
+  ~csPDFiumProgressiveRendererImpl()
+  {
+    if( page.isNull() ) {
+      return;
+    }
+
+    QMutexLocker locker(&(page->doc->mutex));
+    close();
+    if( bitmap != NULL ) {
+      FPDFBitmap_Destroy(bitmap);
+      bitmap = NULL;
+    }
+  }
+
+  // NOTE: Requires a locked 'page'!
+  inline void close()
+  {
+    if( page->handle->progressive == this ) {
+      {
+        CSPDFIUM_GLOBALLOCK();
+        FPDF_RenderPage_Close(page->page);
+      }
+      page->handle->releaseProgressive(this);
+    }
+  }
+
+  static FPDF_BOOL needToPauseNow(IFSDK_PAUSE *pThis)
+  {
+    const csPDFiumProgressiveRendererImpl *impl =
+        static_cast<const csPDFiumProgressiveRendererImpl*>(pThis->user);
+    return impl->abort.load() != 0  ||  impl->timer.hasExpired(impl->budget);
+  }
+
+  QAtomicInt abort;
+  FPDF_BITMAP bitmap;
+  qint64 budget;
+  QImage image;
+  QSharedPointer<csPDFiumPageImpl> page;
+  IFSDK_PAUSE pause;
+  QRect rect; // Rendered tile
+  QSize size; // Rendered page
+  csPDFiumProgressiveRenderer::Status status;
+  QElapsedTimer timer;
+};
+
+#endif // CSPDFIUMPROGRESSIVERENDERERIMPL_H
@@ -0,0 +1,96 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMRENDERTASK_H
+#define CSPDFIUMRENDERTASK_H
+
+#include <QtCore/QFuture>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QRunnable>
+#include <QtGui/QImage>
+
+#include <csPDFium/csPDFiumPage.h>
+#include <csPDFium/csPDFiumProgressiveRenderer.h>
+
+#define CSPDFIUM_RENDER_SLICE  50 // [ms]
+
+class csPDFiumRenderTask : public QRunnable {
+public:
+  csPDFiumRenderTask(const csPDFiumPage& page, const qreal scale,
+                     const QRect& tile = QRect())
+    : _page(page)
+    , _scale(scale)
+    , _tile(tile)
+    , _result()
+  {
+    setAutoDelete(true);
+    _result.reportStarted();
+  }
+
+  ~csPDFiumRenderTask()
+  {
+  }
+
+  inline QFuture<QImage> future()
+  {
+    return _result.future();
+  }
+
+  void run()
+  {
+    // NOTE: Canceled requests still waiting in the queue are skipped!
+    if( !_result.isCanceled() ) {
+      csPDFiumProgressiveRenderer renderer(_page, _scale, _tile);
+      csPDFiumProgressiveRenderer::Status status = renderer.render(CSPDFIUM_RENDER_SLICE);
+      while( status == csPDFiumProgressiveRenderer::Ready  ||
+             status == csPDFiumProgressiveRenderer::Incomplete ) {
+        if( _result.isCanceled() ) {
+          renderer.abort();
+        }
+        status = renderer.render(CSPDFIUM_RENDER_SLICE);
+      }
+      if( status == csPDFiumProgressiveRenderer::Done ) {
+        _result.reportResult(renderer.image());
+      }
+    }
+    _result.reportFinished();
+  }
+
+private:
+  Q_DISABLE_COPY(csPDFiumRenderTask)
+
+  csPDFiumPage _page;
+  qreal _scale;
+  QRect _tile;
+  QFutureInterface<QImage> _result;
+};
+
+#endif // CSPDFIUMRENDERTASK_H
@@ -0,0 +1,74 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMTEXTLAYER_H
+#define CSPDFIUMTEXTLAYER_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <csPDFium/csPDFiumText.h>
+#include <csPDFium/csPDFiumTextChars.h>
+
+// NOTE: A page's text as extracted in ONE pass over its characters;
+//       every text related query of a page is answered from this layer.
+class csPDFiumTextLayer {
+public:
+  csPDFiumTextLayer()
+    : isLoaded(false)
+    , chars()
+    , text()
+    , texts()
+    , words()
+  {
+  }
+
+  ~csPDFiumTextLayer()
+  {
+  }
+
+  inline void clear()
+  {
+    isLoaded = false;
+    chars.clear();
+    text.clear();
+    texts.clear();
+    words.clear();
+  }
+
+  bool isLoaded;
+  csPDFiumTextChars chars;
+  QString text;        // text[i] == Character i of the page
+  csPDFiumTexts texts; // Word boxes; offset() indexes 'text'
+  QStringList words;   // NOTE: Includes words without a box!
+};
+
+#endif // CSPDFIUMTEXTLAYER_H
@@ -0,0 +1,91 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#ifndef CSPDFIUMTEXTTASK_H
+#define CSPDFIUMTEXTTASK_H
+
+#include <QtCore/QFuture>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QRunnable>
+
+#include <csPDFium/csPDFiumDocument.h>
+
+// NOTE: A single worker per request; the document's pages are served one at
+//       a time, hence more workers would merely wait on its lock.
+// CAUTION: Page load & FPDFText_LoadPage() share PDFium's process-wide font
+//          state; they are serialized by util::globalMutex().
+class csPDFiumTextTask : public QRunnable {
+public:
+  csPDFiumTextTask(const csPDFiumDocument& doc, const int first, const int last)
+    : _doc(doc)
+    , _first(first)
+    , _last(last)
+    , _result()
+  {
+    setAutoDelete(true);
+    _result.reportStarted();
+    _result.setProgressRange(0, last-first+1);
+    _result.setProgressValue(0);
+  }
+
+  ~csPDFiumTextTask()
+  {
+  }
+
+  inline QFuture<csPDFiumTextPage> future()
+  {
+    return _result.future();
+  }
+
+  void run()
+  {
+    for(int no = _first; no <= _last  &&  !_result.isCanceled(); no++) {
+      if( _result.isPaused() ) {
+        _result.waitForResume();
+      }
+
+      // NOTE: Results are indexed by page, i.e. they merge in page order.
+      _result.reportResult(_doc.streamTextPage(no, nullptr), no-_first);
+      _result.setProgressValue(no-_first+1);
+    }
+    _result.reportFinished();
+  }
+
+private:
+  Q_DISABLE_COPY(csPDFiumTextTask)
+
+  csPDFiumDocument _doc;
+  int _first;
+  int _last;
+  QFutureInterface<csPDFiumTextPage> _result;
+};
+
+#endif // CSPDFIUMTEXTTASK_H
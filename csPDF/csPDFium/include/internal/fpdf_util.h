@@ -38,11 +38,18 @@
 #include <fpdf_missing.h>
 #include <fpdf_text.h>
 
+#include <QtCore/QMutex>
+#include <QtCore/QRect>
+#include <QtGui/QImage>
 #include <QtGui/QMatrix>
 
 #include <csPDFium/csPDFium.h>
 #include <csPDFium/csPDFiumContentsNode.h>
+#include <csPDFium/csPDFiumDocument.h>
 #include <csPDFium/csPDFiumText.h>
+#include <csPDFium/csPDFiumTextChars.h>
+
+#include "internal/csPDFiumTextLayer.h"
 
 // cf. "fx_ge.h" for FXPT_* aka. FPDF_PATH_* Definitions
 // cf. "fx_ge.h" for FXFILL_* aka. FPDF_FILL_* Definitions
@@ -51,11 +58,22 @@
 // cf. "fx_agg_path_storage.[cpp|h]" for Path Construction
 // cf. "fpdf_page[obj].h" for Page Objects
 
+// NOTE: PDFium's font cache & FreeType library are process-wide and unguarded;
+//       cf. CFX_GEModule::GetFontCache(). Every call that may load, render or
+//       release fonts holds this lock, acquired AFTER the document's mutex and
+//       never held while acquiring another lock.
+#define CSPDFIUM_GLOBALLOCK() \
+  QMutexLocker globalLocker(util::globalMutex())
+
 namespace util {
 
-  csPDFiumTexts extractTexts(const FPDF_PAGE page, const QMatrix& ctm);
+  QMutex *globalMutex();
+
+  void extractTextChars(const FPDF_TEXTPAGE textPage, const QMatrix& ctm,
+                        csPDFiumTextChars& chars);
 
-  QStringList extractWords(const FPDF_PAGE page);
+  void extractTextLayer(const FPDF_PAGE page, const QMatrix& ctm,
+                        csPDFiumTextLayer& layer);
 
   void parseContents(const FPDF_BOOKMARK bookmark, const FPDF_DOCUMENT doc,
                      csPDFiumContentsNode *parent);
@@ -65,6 +83,23 @@ namespace util {
 
   QMatrix getPageCTM(const FPDF_PAGE page);
 
+  csPDFiumPageGeometry getPageGeometry(const FPDF_DOCUMENT doc, const int no);
+
+  QSize getRenderSize(const FPDF_PAGE page, const qreal scale);
+
+  QRect getRenderRect(const FPDF_PAGE page, const qreal scale, const QRect& tile);
+
+  QRect toPixels(const QRectF& rect, const qreal scale);
+
+  int getRenderFlags(const QImage::Format format);
+
+  bool isRenderFormat(const QImage::Format format);
+
+  bool renderPageBitmap(const FPDF_PAGE page,
+                        uchar *data, const QSize& size, const int bytesPerLine,
+                        const QImage::Format format,
+                        const QPoint& offset, const QSize& pageSize);
+
 } // namespace util
 
 #endif // FPDF_UTIL_H
@@ -29,10 +29,19 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+
 #include <fpdfview.h>
 
 #include <csPDFium/csPDFium.h>
 
+#include "internal/fpdf_util.h"
+
+Q_GLOBAL_STATIC(QThreadPool, renderPool)
+Q_GLOBAL_STATIC(QThreadPool, textPool)
+Q_GLOBAL_STATIC(QMutex, pdfiumMutex)
+
 namespace csPDFium {
 
   CS_PDFIUM_EXPORT const qreal DPI(72.0);
@@ -44,7 +53,28 @@ namespace csPDFium {
 
   CS_PDFIUM_EXPORT void destroy()
   {
+    renderPool()->waitForDone();
+    textPool()->waitForDone();
     FPDF_DestroyLibrary();
   }
 
+  CS_PDFIUM_EXPORT QThreadPool *renderThreadPool()
+  {
+    return renderPool();
+  }
+
+  CS_PDFIUM_EXPORT QThreadPool *textThreadPool()
+  {
+    return textPool();
+  }
+
 } // namespace csPDFium
+
+namespace util {
+
+  QMutex *globalMutex()
+  {
+    return pdfiumMutex();
+  }
+
+} // namespace util
@@ -0,0 +1,90 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <csPDFium/csPDFiumBitmapPool.h>
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPDFiumBitmapPool::csPDFiumBitmapPool(const int maxBitmaps)
+  : _mutex()
+  , _bitmaps()
+  , _maxBitmaps(qMax(0, maxBitmaps))
+{
+}
+
+csPDFiumBitmapPool::~csPDFiumBitmapPool()
+{
+}
+
+void csPDFiumBitmapPool::clear()
+{
+  QMutexLocker locker(&_mutex);
+  _bitmaps.clear();
+}
+
+int csPDFiumBitmapPool::count() const
+{
+  QMutexLocker locker(&_mutex);
+  return _bitmaps.size();
+}
+
+int csPDFiumBitmapPool::maxBitmaps() const
+{
+  return _maxBitmaps;
+}
+
+QImage csPDFiumBitmapPool::acquire(const QSize& size, const QImage::Format format)
+{
+  {
+    QMutexLocker locker(&_mutex);
+    for(int i = 0; i < _bitmaps.size(); i++) {
+      if( _bitmaps[i].size() == size  &&  _bitmaps[i].format() == format ) {
+        return _bitmaps.takeAt(i);
+      }
+    }
+  }
+
+  return QImage(size, format);
+}
+
+void csPDFiumBitmapPool::release(QImage& image)
+{
+  if( image.isNull()  ||  !image.isDetached() ) {
+    image = QImage();
+    return;
+  }
+
+  QMutexLocker locker(&_mutex);
+  if( _bitmaps.size() < _maxBitmaps ) {
+    _bitmaps.push_back(image);
+  }
+  image = QImage();
+}
@@ -30,6 +30,7 @@
 *****************************************************************************/
 
 #include <QtCore/QFile>
+#include <QtCore/QThreadPool>
 
 #include <csPDFium/csPDFiumDocument.h>
 
@@ -37,8 +38,37 @@
 
 #include "internal/csPDFiumDocumentImpl.h"
 #include "internal/csPDFiumPageImpl.h"
+#include "internal/csPDFiumPageTask.h"
+#include "internal/csPDFiumTextTask.h"
 #include "internal/fpdf_util.h"
 
+namespace priv {
+
+  // NOTE: Caller must hold impl->mutex! Unless cached, the page is closed
+  //       again upon return.
+  static csPDFiumTextPage loadTextPage(csPDFiumDocumentImpl *impl,
+                                       const csPDFiumPageGeometries& geometry,
+                                       const int no, QStringList *words)
+  {
+    if( no < 0  ||  no >= geometry.size() ) {
+      return csPDFiumTextPage();
+    }
+
+    const csPDFiumPageHandlePtr handle = impl->loadPage(no, false);
+    if( handle.isNull() ) {
+      return csPDFiumTextPage();
+    }
+
+    const csPDFiumTextLayer& layer = handle->textLayer(impl->pageCTM(no, handle));
+    if( words != nullptr ) {
+      *words = layer.words;
+    }
+
+    return csPDFiumTextPage(no, layer.texts);
+  }
+
+} // namespace priv
+
 csPDFiumDocument::csPDFiumDocument()
   : impl()
 {
@@ -94,9 +124,7 @@ int csPDFiumDocument::pageCount() const
     return -1;
   }
 
-  CSPDFIUM_DOCIMPL();
-
-  return FPDF_GetPageCount(impl->document);
+  return impl->geometry.size();
 }
 
 csPDFiumPage csPDFiumDocument::page(const int no) const
@@ -107,7 +135,7 @@ csPDFiumPage csPDFiumDocument::page(const int no) const
 
   CSPDFIUM_DOCIMPL();
 
-  if( no < 0  ||  no >= FPDF_GetPageCount(impl->document) ) {
+  if( no < 0  ||  no >= impl->geometry.size() ) {
     return csPDFiumPage();
   }
 
@@ -116,13 +144,14 @@ csPDFiumPage csPDFiumDocument::page(const int no) const
     return csPDFiumPage();
   }
 
-  pimpl->page = FPDF_LoadPage(impl->document, no);
-  if( pimpl->page == NULL ) {
+  pimpl->handle = impl->loadPage(no);
+  if( pimpl->handle.isNull() ) {
     delete pimpl;
     return csPDFiumPage();
   }
 
-  pimpl->ctm = util::getPageCTM(pimpl->page);
+  pimpl->page = pimpl->handle->page;
+  pimpl->ctm  = impl->pageCTM(no, pimpl->handle);
   pimpl->doc = impl;
   pimpl->no  = no;
 
@@ -132,6 +161,39 @@ csPDFiumPage csPDFiumDocument::page(const int no) const
   return page;
 }
 
+QFuture<csPDFiumPage> csPDFiumDocument::pageAsync(const int no, const int priority) const
+{
+  csPDFiumPageTask *task = new csPDFiumPageTask(*this, no);
+  const QFuture<csPDFiumPage> future = task->future();
+
+  csPDFium::renderThreadPool()->start(task, priority);
+
+  return future;
+}
+
+QSizeF csPDFiumDocument::pageSize(const int no) const
+{
+  return pageGeometry(no).size;
+}
+
+csPDFiumPageGeometry csPDFiumDocument::pageGeometry(const int no) const
+{
+  if( isEmpty()  ||  no < 0  ||  no >= impl->geometry.size() ) {
+    return csPDFiumPageGeometry();
+  }
+
+  return impl->geometry[no];
+}
+
+csPDFiumPageGeometries csPDFiumDocument::pageGeometries() const
+{
+  if( isEmpty() ) {
+    return csPDFiumPageGeometries();
+  }
+
+  return impl->geometry;
+}
+
 csPDFiumContentsNode *csPDFiumDocument::tableOfContents() const
 {
   if( isEmpty() ) {
@@ -157,22 +219,16 @@ csPDFiumTextPage csPDFiumDocument::textPage(const int no) const
 
   CSPDFIUM_DOCIMPL();
 
-  if( no < 0  ||  no >= FPDF_GetPageCount(impl->document) ) {
+  if( no < 0  ||  no >= impl->geometry.size() ) {
     return csPDFiumTextPage();
   }
 
-  const FPDF_PAGE page = FPDF_LoadPage(impl->document, no);
-  if( page == NULL ) {
+  const csPDFiumPageHandlePtr handle = impl->loadPage(no);
+  if( handle.isNull() ) {
     return csPDFiumTextPage();
   }
 
-  const QMatrix ctm = util::getPageCTM(page);
-
-  const csPDFiumTextPage result(no, util::extractTexts(page, ctm));
-
-  FPDF_ClosePage(page);
-
-  return result;
+  return csPDFiumTextPage(no, handle->textLayer(impl->pageCTM(no, handle)).texts);
 }
 
 csPDFiumTextPages csPDFiumDocument::textPages(const int first, const int count) const
@@ -183,7 +239,7 @@ csPDFiumTextPages csPDFiumDocument::textPages(const int first, const int count)
 
   CSPDFIUM_DOCIMPL();
 
-  const int pageCount = FPDF_GetPageCount(impl->document);
+  const int pageCount = impl->geometry.size();
   if( first < 0  ||  first >= pageCount ) {
     return csPDFiumTextPages();
   }
@@ -194,22 +250,41 @@ csPDFiumTextPages csPDFiumDocument::textPages(const int first, const int count)
 
   csPDFiumTextPages results;
   for(int pageNo = first; pageNo <= last; pageNo++) {
-    const FPDF_PAGE page = FPDF_LoadPage(impl->document, pageNo);
-    if( page == NULL ) {
+    const csPDFiumPageHandlePtr handle = impl->loadPage(pageNo, false);
+    if( handle.isNull() ) {
       continue;
     }
 
-    const QMatrix ctm = util::getPageCTM(page);
-
     results.push_back(csPDFiumTextPage(pageNo,
-                                       util::extractTexts(page, ctm)));
-
-    FPDF_ClosePage(page);
+                                       handle->textLayer(impl->pageCTM(pageNo, handle)).texts));
   }
 
   return results;
 }
 
+QFuture<csPDFiumTextPage> csPDFiumDocument::textPagesAsync(const int first,
+                                                          const int count) const
+{
+  const int numPages = pageCount();
+  if( first < 0  ||  first >= numPages ) {
+    QFutureInterface<csPDFiumTextPage> none;
+    none.reportStarted();
+    none.reportFinished();
+    return none.future();
+  }
+
+  const int last = count <= 0
+      ? numPages-1
+      : qBound(0, first+count-1, numPages-1);
+
+  csPDFiumTextTask *task = new csPDFiumTextTask(*this, first, last);
+  const QFuture<csPDFiumTextPage> future = task->future();
+
+  csPDFium::textThreadPool()->start(task);
+
+  return future;
+}
+
 csPDFiumDest csPDFiumDocument::resolveBookmark(const void *pointer) const
 {
   if( isEmpty() ) {
@@ -255,9 +330,9 @@ csPDFiumWordsPages csPDFiumDocument::wordsPages(const int firstIndex,
 
   CSPDFIUM_DOCIMPL();
 
-  const int pageCount = FPDF_GetPageCount(impl->document);
+  const int pageCount = impl->geometry.size();
   if( firstIndex < 0  ||  firstIndex >= pageCount ) {
-    csPDFiumWordsPages();
+    return csPDFiumWordsPages();
   }
 
   const int lastIndex = count <= 0
@@ -266,22 +341,31 @@ csPDFiumWordsPages csPDFiumDocument::wordsPages(const int firstIndex,
 
   csPDFiumWordsPages result;
   for(int index = firstIndex; index <= lastIndex; index++) {
-    const FPDF_PAGE page = FPDF_LoadPage(impl->document, index);
-    if( page == NULL ) {
+    const csPDFiumPageHandlePtr handle = impl->loadPage(index, false);
+    if( handle.isNull() ) {
       continue;
     }
 
-    const csPDFiumWordsPage wordsPage(index, util::extractWords(page));
-    if( !wordsPage.second.isEmpty() ) {
-      result.push_back(wordsPage);
+    const QStringList& words = handle->textLayer(impl->pageCTM(index, handle)).words;
+    if( !words.isEmpty() ) {
+      result.push_back(csPDFiumWordsPage(index, words));
     }
-
-    FPDF_ClosePage(page);
   }
 
   return result;
 }
 
+void csPDFiumDocument::setPageCacheLimits(const int maxPages, const int maxSizeMB)
+{
+  if( isEmpty() ) {
+    return;
+  }
+
+  CSPDFIUM_DOCIMPL();
+
+  impl->pages.setLimits(maxPages, qint64(maxSizeMB)*1024*1024);
+}
+
 csPDFiumDocument csPDFiumDocument::load(const QString& filename,
                                         const bool memory,
                                         const QByteArray& password,
@@ -314,28 +398,46 @@ csPDFiumDocument csPDFiumDocument::load(const QString& filename,
       return csPDFiumDocument();
     }
     file.close();
+  }
 
-    impl->document = FPDF_LoadMemDocument(impl->data.constData(),
-                                          impl->data.size(), pdf_password);
+  unsigned long error = FPDF_ERR_SUCCESS;
+  {
+    // NOTE: PDFium's last error is process-wide, too!
+    CSPDFIUM_GLOBALLOCK();
 
-  } else {
+    if( memory ) {
+      impl->document = FPDF_LoadMemDocument(impl->data.constData(),
+                                            impl->data.size(), pdf_password);
+    } else {
 #ifndef Q_OS_WIN // ASSUMPTION: All other OSes treat paths as UTF-8...
-    impl->document = FPDF_LoadDocument(filename.toUtf8().constData(), pdf_password);
+      impl->document = FPDF_LoadDocument(filename.toUtf8().constData(), pdf_password);
 #else
-    // NOTE: PDFium uses UTF-16LE encoding!
-    impl->document = FPDF_LoadDocumentW(filename.utf16(), pdf_password);
+      // NOTE: PDFium uses UTF-16LE encoding!
+      impl->document = FPDF_LoadDocumentW(filename.utf16(), pdf_password);
 #endif
+    }
+
+    if( impl->document == NULL ) {
+      error = FPDF_GetLastError();
+    }
   }
 
   if( impl->document == NULL ) {
     if( pw_required != nullptr ) {
-      *pw_required = FPDF_GetLastError() == FPDF_ERR_PASSWORD;
+      *pw_required = error == FPDF_ERR_PASSWORD;
     }
 
     delete impl;
     return csPDFiumDocument();
   }
 
+  // NOTE: Page geometry is computed without parsing any content stream.
+  const int pageCount = FPDF_GetPageCount(impl->document);
+  impl->geometry.reserve(qMax(0, pageCount));
+  for(int no = 0; no < pageCount; no++) {
+    impl->geometry.push_back(util::getPageGeometry(impl->document, no));
+  }
+
   csPDFiumDocument doc;
   doc.impl = QSharedPointer<csPDFiumDocumentImpl>(impl);
 
@@ -373,3 +475,15 @@ csPDFiumDest csPDFiumDocument::createDest(const void *_dest, const void *_action
                                 FPDFDest_GetZoomParam(dest, 1))
                       : QPointF());
 }
+
+csPDFiumTextPage csPDFiumDocument::streamTextPage(const int no,
+                                                  QStringList *words) const
+{
+  if( isEmpty() ) {
+    return csPDFiumTextPage();
+  }
+
+  CSPDFIUM_DOCIMPL();
+
+  return priv::loadTextPage(impl.data(), impl->geometry, no, words);
+}
@@ -29,11 +29,14 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <QtCore/QThreadPool>
+
 #include <fpdf_doc.h>
 
 #include <csPDFium/csPDFiumPage.h>
 
 #include "internal/csPDFiumPageImpl.h"
+#include "internal/csPDFiumRenderTask.h"
 #include "internal/fpdf_util.h"
 
 csPDFiumPage::csPDFiumPage()
@@ -86,6 +89,16 @@ int csPDFiumPage::number() const
 }
 
 QImage csPDFiumPage::renderToImage(const qreal scale) const
+{
+  return renderTile(QRect(), scale);
+}
+
+QFuture<QImage> csPDFiumPage::renderAsync(const qreal scale, const int priority) const
+{
+  return renderTileAsync(QRect(), scale, priority);
+}
+
+QImage csPDFiumPage::renderTile(const QRect& tile, const qreal scale) const
 {
   if( isEmpty() ) {
     return QImage();
@@ -93,39 +106,124 @@ QImage csPDFiumPage::renderToImage(const qreal scale) const
 
   CSPDFIUM_PAGEIMPL();
 
-  const qreal w = FPDF_GetPageWidth(impl->page);
-  const qreal h = FPDF_GetPageHeight(impl->page);
+  const QSize size = util::getRenderSize(impl->page, scale);
+  const QRect rect = util::getRenderRect(impl->page, scale, tile);
+  if( rect.isEmpty() ) {
+    return QImage();
+  }
 
-  QImage image(w*scale, h*scale, QImage::Format_RGBA8888);
+  QImage image(rect.size(), QImage::Format_RGBA8888);
   if( image.isNull() ) {
     return QImage();
   }
-  image.fill(0xFFFFFFFF);
 
-  FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(image.width(), image.height(),
-                                           FPDFBitmap_BGRA,
-                                           image.scanLine(0), image.bytesPerLine());
-  if( bitmap == NULL ) {
+  // NOTE: Rendering would discard a pending progressive render context!
+  if( !impl->handle->waitForProgressive(&(impl->doc->mutex))  ||
+      !util::renderPageBitmap(impl->page,
+                              image.bits(), image.size(), image.bytesPerLine(),
+                              image.format(), rect.topLeft(), size) ) {
+    return QImage();
+  }
+
+  return image;
+}
+
+QImage csPDFiumPage::renderTile(const QRect& tile, const qreal scale,
+                                const QImage::Format format,
+                                csPDFiumBitmapPool *pool) const
+{
+  if( isEmpty()  ||  !util::isRenderFormat(format) ) {
     return QImage();
   }
 
-  FPDF_RenderPageBitmap(bitmap, impl->page,
-                        0, 0, image.width(), image.height(),
-                        0, 0); // no rotation, no flags
-  FPDFBitmap_Destroy(bitmap);
-  bitmap = NULL;
-
-  for(int i = 0; i < image.height(); i++) {
-    uchar *pixels = image.scanLine(i);
-    for(int j = 0; j < image.width(); j++) {
-      qSwap(pixels[0], pixels[2]);
-      pixels += 4;
+  CSPDFIUM_PAGEIMPL();
+
+  const QSize size = util::getRenderSize(impl->page, scale);
+  const QRect rect = util::getRenderRect(impl->page, scale, tile);
+  if( rect.isEmpty() ) {
+    return QImage();
+  }
+
+  QImage image = pool != nullptr
+      ? pool->acquire(rect.size(), format)
+      : QImage(rect.size(), format);
+  if( image.isNull() ) {
+    return QImage();
+  }
+
+  if( !impl->handle->waitForProgressive(&(impl->doc->mutex))  ||
+      !util::renderPageBitmap(impl->page,
+                              image.bits(), image.size(), image.bytesPerLine(),
+                              image.format(), rect.topLeft(), size) ) {
+    if( pool != nullptr ) {
+      pool->release(image);
     }
+    return QImage();
   }
 
   return image;
 }
 
+bool csPDFiumPage::renderInto(uchar *data, const QSize& size, const int bytesPerLine,
+                              const QImage::Format format,
+                              const QPoint& offset, const qreal scale) const
+{
+  if( isEmpty() ) {
+    return false;
+  }
+
+  CSPDFIUM_PAGEIMPL();
+
+  if( !impl->handle->waitForProgressive(&(impl->doc->mutex)) ) {
+    return false;
+  }
+
+  return util::renderPageBitmap(impl->page,
+                                data, size, bytesPerLine, format,
+                                offset, util::getRenderSize(impl->page, scale));
+}
+
+bool csPDFiumPage::renderInto(QImage& image,
+                              const QPoint& offset, const qreal scale) const
+{
+  if( image.isNull() ) {
+    return false;
+  }
+
+  return renderInto(image.bits(), image.size(), image.bytesPerLine(),
+                    image.format(), offset, scale);
+}
+
+QFuture<QImage> csPDFiumPage::renderTileAsync(const QRect& tile, const qreal scale,
+                                              const int priority) const
+{
+  csPDFiumRenderTask *task = new csPDFiumRenderTask(*this, scale, tile);
+  const QFuture<QImage> future = task->future();
+
+  csPDFium::renderThreadPool()->start(task, priority);
+
+  return future;
+}
+
+QImage csPDFiumPage::renderRegion(const QRectF& region, const qreal scale) const
+{
+  if( region.isEmpty() ) {
+    return QImage();
+  }
+
+  return renderTile(util::toPixels(region, scale), scale);
+}
+
+QFuture<QImage> csPDFiumPage::renderRegionAsync(const QRectF& region, const qreal scale,
+                                                const int priority) const
+{
+  if( region.isEmpty() ) {
+    return QFuture<QImage>();
+  }
+
+  return renderTileAsync(util::toPixels(region, scale), scale, priority);
+}
+
 csPDFiumLinks csPDFiumPage::links() const
 {
   if( isEmpty() ) {
@@ -189,28 +287,7 @@ QString csPDFiumPage::text() const
 
   CSPDFIUM_PAGEIMPL();
 
-  FPDF_TEXTPAGE textPage = FPDFText_LoadPage(impl->page);
-  if( textPage == NULL ) {
-    return QString();
-  }
-
-  const int numChars = FPDFText_CountChars(textPage);
-  if( numChars < 1 ) {
-    FPDFText_ClosePage(textPage);
-    return QString();
-  }
-
-  const int dataSize = (numChars+1)*sizeof(unsigned short);
-  QByteArray data(dataSize, '\0');
-  if( data.size() != dataSize ) {
-    FPDFText_ClosePage(textPage);
-    return QString();
-  }
-
-  FPDFText_GetText(textPage, 0, numChars, (unsigned short*)data.data());
-  FPDFText_ClosePage(textPage);
-
-  return QString::fromUtf16((const unsigned short*)data.constData());
+  return impl->handle->textLayer(impl->ctm).text;
 }
 
 csPDFiumTexts csPDFiumPage::texts(const QRectF& area) const
@@ -221,16 +298,13 @@ csPDFiumTexts csPDFiumPage::texts(const QRectF& area) const
 
   CSPDFIUM_PAGEIMPL();
 
-  if( impl->textCache.isEmpty() ) {
-    impl->textCache = util::extractTexts(impl->page, impl->ctm);
-  }
-
+  const csPDFiumTexts& cache = impl->handle->textLayer(impl->ctm).texts;
   if( area.isNull() ) {
-    return impl->textCache;
+    return cache;
   }
 
   csPDFiumTexts texts;
-  foreach(const csPDFiumText& t, impl->textCache) {
+  foreach(const csPDFiumText& t, cache) {
     if( area.intersects(t.rect()) ) {
       texts.push_back(t);
     }
@@ -247,11 +321,18 @@ QStringList csPDFiumPage::words() const
 
   CSPDFIUM_PAGEIMPL();
 
-  if( impl->wordCache.isEmpty() ) {
-    impl->wordCache = util::extractWords(impl->page);
+  return impl->handle->textLayer(impl->ctm).words;
+}
+
+csPDFiumTextChars csPDFiumPage::textChars() const
+{
+  if( isEmpty() ) {
+    return csPDFiumTextChars();
   }
 
-  return impl->wordCache;
+  CSPDFIUM_PAGEIMPL();
+
+  return impl->handle->textLayer(impl->ctm).chars;
 }
 
 QList<QPainterPath> csPDFiumPage::extractPaths(const csPDFium::PathExtractionFlags flags) const
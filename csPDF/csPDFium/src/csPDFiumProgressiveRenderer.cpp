@@ -0,0 +1,201 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <csPDFium/csPDFiumProgressiveRenderer.h>
+
+#include "internal/csPDFiumProgressiveRendererImpl.h"
+#include "internal/fpdf_util.h"
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPDFiumProgressiveRenderer::csPDFiumProgressiveRenderer(const csPDFiumPage& page,
+                                                         const qreal scale,
+                                                         const QRect& tile)
+  : impl()
+{
+  if( page.isEmpty() ) {
+    return;
+  }
+
+  csPDFiumProgressiveRendererImpl *pimpl = new csPDFiumProgressiveRendererImpl();
+  if( pimpl == nullptr ) {
+    return;
+  }
+  impl = QSharedPointer<csPDFiumProgressiveRendererImpl>(pimpl);
+
+  impl->page = page.impl;
+
+  CSPDFIUM_RENDERERIMPL();
+
+  impl->size = util::getRenderSize(impl->page->page, scale);
+  impl->rect = util::getRenderRect(impl->page->page, scale, tile);
+  if( impl->rect.isEmpty() ) {
+    impl->status = Failed;
+    return;
+  }
+
+  impl->image = QImage(impl->rect.size(), QImage::Format_RGBA8888);
+  if( impl->image.isNull() ) {
+    impl->status = Failed;
+    return;
+  }
+  impl->image.fill(0xFFFFFFFF);
+
+  // NOTE: FPDF_REVERSE_BYTE_ORDER renders RGBA straight into 'impl->image'.
+  impl->bitmap = FPDFBitmap_CreateEx(impl->image.width(), impl->image.height(),
+                                     FPDFBitmap_BGRA,
+                                     impl->image.scanLine(0),
+                                     impl->image.bytesPerLine());
+  if( impl->bitmap == NULL ) {
+    impl->status = Failed;
+    return;
+  }
+
+  impl->status = Ready;
+}
+
+csPDFiumProgressiveRenderer::~csPDFiumProgressiveRenderer()
+{
+}
+
+bool csPDFiumProgressiveRenderer::isEmpty() const
+{
+  return impl.isNull();
+}
+
+void csPDFiumProgressiveRenderer::clear()
+{
+  impl.clear();
+}
+
+csPDFiumProgressiveRenderer::Status csPDFiumProgressiveRenderer::status() const
+{
+  if( isEmpty() ) {
+    return Invalid;
+  }
+
+  CSPDFIUM_RENDERERIMPL();
+
+  return impl->status;
+}
+
+QImage csPDFiumProgressiveRenderer::image() const
+{
+  if( isEmpty() ) {
+    return QImage();
+  }
+
+  CSPDFIUM_RENDERERIMPL();
+
+  if( impl->status == Invalid  ||  impl->status == Failed ) {
+    return QImage();
+  }
+
+  // NOTE: Deep copy; PDFium keeps on writing into 'impl->image'!
+  return impl->image.copy();
+}
+
+csPDFiumProgressiveRenderer::Status csPDFiumProgressiveRenderer::render(const int budget)
+{
+  if( isEmpty() ) {
+    return Invalid;
+  }
+
+  CSPDFIUM_RENDERERIMPL();
+
+  if( impl->status != Ready  &&  impl->status != Incomplete ) {
+    return impl->status;
+  }
+
+  if( impl->abort.load() != 0 ) {
+    impl->close();
+    impl->status = Aborted;
+    return impl->status;
+  }
+
+  impl->budget = qMax(0, budget);
+  impl->timer.start();
+
+  // NOTE: Queued behind another progressive render of 'page'; cf. render().
+  if( impl->status == Ready  &&
+      !impl->page->handle->waitForProgressive(locker.mutex(), impl->budget) ) {
+    return impl->status;
+  }
+
+  int result = FPDF_RENDER_FAILED;
+  if( impl->status == Ready ) {
+    impl->page->handle->progressive = impl.data();
+    CSPDFIUM_GLOBALLOCK();
+    result = FPDF_RenderPageBitmap_Start(impl->bitmap, impl->page->page,
+                                         -impl->rect.x(), -impl->rect.y(),
+                                         impl->size.width(), impl->size.height(),
+                                         0, FPDF_REVERSE_BYTE_ORDER, // no rotation
+                                         &impl->pause);
+  } else {
+    CSPDFIUM_GLOBALLOCK();
+    result = FPDF_RenderPage_Continue(impl->page->page, &impl->pause);
+  }
+
+  if(        result == FPDF_RENDER_DONE ) {
+    impl->close();
+    impl->status = Done;
+  } else if( result == FPDF_RENDER_TOBECOUNTINUED ) {
+    if( impl->abort.load() != 0 ) {
+      impl->close();
+      impl->status = Aborted;
+    } else {
+      impl->status = Incomplete;
+    }
+  } else {
+    impl->close();
+    impl->status = Failed;
+  }
+
+  return impl->status;
+}
+
+void csPDFiumProgressiveRenderer::abort()
+{
+  if( isEmpty() ) {
+    return;
+  }
+
+  impl->abort.store(1);
+
+  // NOTE: render() holds the lock for a whole slice, i.e. none is running
+  //       once we get it; release the page right away.
+  CSPDFIUM_RENDERERIMPL();
+
+  if( impl->status == Ready  ||  impl->status == Incomplete ) {
+    impl->close();
+    impl->status = Aborted;
+  }
+}
@@ -0,0 +1,95 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include <csPDFium/csPDFiumTextPageIterator.h>
+
+////// public ////////////////////////////////////////////////////////////////
+
+csPDFiumTextPageIterator::csPDFiumTextPageIterator(const csPDFiumDocument& doc,
+                                                   const int first, const int count)
+  : _doc(doc)
+  , _next(0)
+  , _last(-1)
+{
+  const int pageCount = _doc.pageCount();
+  if( first < 0  ||  first >= pageCount ) {
+    return;
+  }
+
+  _next = first;
+  _last = count <= 0
+      ? pageCount-1
+      : qBound(0, first+count-1, pageCount-1);
+}
+
+csPDFiumTextPageIterator::~csPDFiumTextPageIterator()
+{
+}
+
+bool csPDFiumTextPageIterator::hasNext() const
+{
+  return _next <= _last;
+}
+
+int csPDFiumTextPageIterator::nextPageNo() const
+{
+  return hasNext()
+      ? _next
+      : -1;
+}
+
+int csPDFiumTextPageIterator::remaining() const
+{
+  return qMax(0, _last-_next+1);
+}
+
+csPDFiumTextPage csPDFiumTextPageIterator::next()
+{
+  if( !hasNext() ) {
+    return csPDFiumTextPage();
+  }
+
+  return _doc.streamTextPage(_next++, nullptr);
+}
+
+csPDFiumWordsPage csPDFiumTextPageIterator::nextWords()
+{
+  if( !hasNext() ) {
+    return csPDFiumWordsPage(-1, QStringList());
+  }
+
+  const int no = _next++;
+
+  QStringList words;
+  _doc.streamTextPage(no, &words);
+
+  return csPDFiumWordsPage(no, words);
+}
@@ -29,10 +29,17 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <QtCore/QByteArray>
+#include <QtCore/QThreadStorage>
+
 #include "internal/fpdf_util.h"
+#include "internal/pixel_util.h"
 
 namespace util {
 
+  // NOTE: Per render thread; grows to the largest converted bitmap.
+  static QThreadStorage<QByteArray> renderScratch;
+
   QMatrix getPageCTM(const FPDF_PAGE page)
   {
     const qreal h = FPDF_GetPageHeight(page);
@@ -46,4 +53,131 @@ namespace util {
     return  ctm;
   }
 
+  csPDFiumPageGeometry getPageGeometry(const FPDF_DOCUMENT doc, const int no)
+  {
+    double w, h, a, b, c, d, e, f;
+    int rotation;
+    csPDFiumPageGeometry geometry;
+    if( !FPDF_GetPageGeometryByIndex(doc, no, &w, &h, &rotation,
+                                     &a, &b, &c, &d, &e, &f) ) {
+      // NOTE: The size still serves the layout; the matrix is taken from the
+      //       loaded page instead.
+      if( FPDF_GetPageSizeByIndex(doc, no, &w, &h) ) {
+        geometry.size = QSizeF(w, h);
+      }
+      return geometry;
+    }
+
+    geometry.size     = QSizeF(w, h);
+    geometry.rotation = rotation;
+    geometry.ctm      = QMatrix(a, b, c, d, e, f);
+    geometry.ctm     *= QMatrix(1, 0, 0, -1, 0, h);
+    geometry.exact    = true;
+
+    return geometry;
+  }
+
+  QSize getRenderSize(const FPDF_PAGE page, const qreal scale)
+  {
+    const qreal w = FPDF_GetPageWidth(page);
+    const qreal h = FPDF_GetPageHeight(page);
+
+    return QSize(w*scale, h*scale);
+  }
+
+  QRect getRenderRect(const FPDF_PAGE page, const qreal scale, const QRect& tile)
+  {
+    const QRect rect(QPoint(0, 0), getRenderSize(page, scale));
+
+    return tile.isNull()
+        ? rect
+        : tile & rect;
+  }
+
+  QRect toPixels(const QRectF& rect, const qreal scale)
+  {
+    return QRectF(rect.topLeft()*scale, rect.size()*scale).toAlignedRect();
+  }
+
+  int getRenderFlags(const QImage::Format format)
+  {
+    // NOTE: PDFium renders 32bpp BGRA or, reversed, RGBA; the page is opaque.
+    switch( format ) {
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+    case QImage::Format_RGBX8888:
+      return FPDF_REVERSE_BYTE_ORDER;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+    case QImage::Format_RGB32:
+      return 0;
+#endif
+    default:
+      break;
+    }
+
+    return -1;
+  }
+
+  bool isRenderFormat(const QImage::Format format)
+  {
+    return getRenderFlags(format) >= 0
+        || format == QImage::Format_RGB888
+        || format == QImage::Format_Grayscale8;
+  }
+
+  bool renderPageBitmap(const FPDF_PAGE page,
+                        uchar *data, const QSize& size, const int bytesPerLine,
+                        const QImage::Format format,
+                        const QPoint& offset, const QSize& pageSize)
+  {
+    if( data == nullptr  ||  size.isEmpty()  ||  !isRenderFormat(format) ) {
+      return false;
+    }
+
+    // NOTE: Formats PDFium cannot emit are converted from a BGRA scratch buffer.
+    const int flags = getRenderFlags(format);
+    uchar *target = data;
+    int targetBpl = bytesPerLine;
+    if( flags < 0 ) {
+      targetBpl = size.width()*4;
+      QByteArray& scratch = renderScratch.localData();
+      if( scratch.size() < targetBpl*size.height() ) {
+        scratch.resize(targetBpl*size.height());
+      }
+      target = reinterpret_cast<uchar*>(scratch.data());
+    }
+
+    // NOTE: PDFium only wraps 'target'; no pixel memory is allocated.
+    FPDF_BITMAP bitmap = FPDFBitmap_CreateEx(size.width(), size.height(),
+                                             FPDFBitmap_BGRA,
+                                             target, targetBpl);
+    if( bitmap == NULL ) {
+      return false;
+    }
+
+    FPDFBitmap_FillRect(bitmap, 0, 0, size.width(), size.height(), 0xFFFFFFFF);
+    {
+      CSPDFIUM_GLOBALLOCK();
+      FPDF_RenderPageBitmap(bitmap, page,
+                            -offset.x(), -offset.y(),
+                            pageSize.width(), pageSize.height(),
+                            0, qMax(0, flags)); // no rotation
+    }
+    FPDFBitmap_Destroy(bitmap);
+
+    if(        format == QImage::Format_RGB888 ) {
+      for(int y = 0; y < size.height(); y++) {
+        convertBgraToRgb888(target + y*targetBpl, data + y*bytesPerLine, size.width());
+      }
+    } else if( format == QImage::Format_Grayscale8 ) {
+      for(int y = 0; y < size.height(); y++) {
+        convertBgraToGray8(target + y*targetBpl, data + y*bytesPerLine, size.width());
+      }
+    }
+
+    return true;
+  }
+
 } // namespace util
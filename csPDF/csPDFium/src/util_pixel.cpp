@@ -0,0 +1,264 @@
+/****************************************************************************
+** Copyright (c) 2016, Carsten Schmidt. All rights reserved.
+**
+** Redistribution and use in source and binary forms, with or without
+** modification, are permitted provided that the following conditions
+** are met:
+**
+** 1. Redistributions of source code must retain the above copyright
+**    notice, this list of conditions and the following disclaimer.
+**
+** 2. Redistributions in binary form must reproduce the above copyright
+**    notice, this list of conditions and the following disclaimer in the
+**    documentation and/or other materials provided with the distribution.
+**
+** 3. Neither the name of the copyright holder nor the names of its
+**    contributors may be used to endorse or promote products derived from
+**    this software without specific prior written permission.
+**
+** THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+** "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+** LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+** A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+** HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+** SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+** LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+** DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+** THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+** (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*****************************************************************************/
+
+#include "internal/pixel_util.h"
+
+#if defined(__x86_64__)  ||  defined(_M_X64)  ||  defined(__i386__)  ||  defined(_M_IX86)
+# define CSPDFIUM_X86
+#endif
+
+#if defined(CSPDFIUM_X86)  &&  (defined(__SSE2__)  ||  defined(_M_X64)  ||  _M_IX86_FP >= 2)
+# define CSPDFIUM_SSE2
+# include <emmintrin.h>
+#endif
+
+#if defined(CSPDFIUM_SSE2)  &&  (defined(__GNUC__)  ||  defined(_MSC_VER))
+# define CSPDFIUM_AVX2
+# include <immintrin.h>
+# if defined(_MSC_VER)
+#  include <intrin.h>
+#  define CSPDFIUM_TARGET_AVX2
+# else
+#  define CSPDFIUM_TARGET_AVX2  __attribute__((target("avx2")))
+# endif
+#endif
+
+////// Private ///////////////////////////////////////////////////////////////
+
+namespace priv {
+
+  typedef void (*ConvertFunc)(const uchar *src, uchar *dst, const int count);
+
+  ////// Scalar //////////////////////////////////////////////////////////////
+
+  static inline uchar gray(const uchar *bgra)
+  {
+    return uchar((77*int(bgra[2]) + 150*int(bgra[1]) + 29*int(bgra[0])) >> 8);
+  }
+
+  static void bgraToRgb888_scalar(const uchar *src, uchar *dst, const int count)
+  {
+    for(int i = 0; i < count; i++, src += 4, dst += 3) {
+      dst[0] = src[2];
+      dst[1] = src[1];
+      dst[2] = src[0];
+    }
+  }
+
+  static void bgraToGray8_scalar(const uchar *src, uchar *dst, const int count)
+  {
+    for(int i = 0; i < count; i++, src += 4) {
+      dst[i] = gray(src);
+    }
+  }
+
+  ////// SSE2 ////////////////////////////////////////////////////////////////
+
+#if defined(CSPDFIUM_SSE2)
+
+  static inline __m128i grayX4_sse2(const __m128i v)
+  {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i b = _mm_and_si128(v, mask);
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(v,  8), mask);
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(v, 16), mask);
+    // NOTE: All products & sums fit into the lower 16 bits of each lane.
+    const __m128i y = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(r, _mm_set1_epi32(77)),
+                                                  _mm_mullo_epi16(g, _mm_set1_epi32(150))),
+                                    _mm_mullo_epi16(b, _mm_set1_epi32(29)));
+    return _mm_srli_epi32(y, 8);
+  }
+
+  static void bgraToRgb888_sse2(const uchar *src, uchar *dst, const int count)
+  {
+    // NOTE: Without a byte shuffle, R & B swap as 16 bit words of the masked
+    //       dwords; each 64 bit lane then packs its two pixels into 6 bytes.
+    const __m128i maskGA = _mm_set1_epi32(0xFF00FF00);
+    const __m128i maskRB = _mm_set1_epi32(0x00FF00FF);
+    const __m128i maskLo = _mm_set_epi32(0, 0x00FFFFFF, 0, 0x00FFFFFF);
+    const __m128i maskHi = _mm_set_epi32(0x0000FFFF, 0xFF000000, 0x0000FFFF, 0xFF000000);
+    int i = 0;
+    // NOTE: Every store writes 4 trailing bytes, which the next one overwrites.
+    for(; i + 4 + 2 <= count; i += 4, src += 16, dst += 12) {
+      const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+      const __m128i rb = _mm_and_si128(v, maskRB);
+      const __m128i s  = _mm_or_si128(_mm_and_si128(v, maskGA),
+                                      _mm_shufflehi_epi16(_mm_shufflelo_epi16(rb, 0xB1), 0xB1));
+      const __m128i q  = _mm_or_si128(_mm_and_si128(s, maskLo),
+                                      _mm_and_si128(_mm_srli_epi64(s, 8), maskHi));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                       _mm_or_si128(_mm_move_epi64(q),
+                                    _mm_slli_si128(_mm_srli_si128(q, 8), 6)));
+    }
+    bgraToRgb888_scalar(src, dst, count - i);
+  }
+
+  static void bgraToGray8_sse2(const uchar *src, uchar *dst, const int count)
+  {
+    int i = 0;
+    for(; i + 16 <= count; i += 16, src += 64, dst += 16) {
+      const __m128i *p = reinterpret_cast<const __m128i*>(src);
+      const __m128i y0 = grayX4_sse2(_mm_loadu_si128(p + 0));
+      const __m128i y1 = grayX4_sse2(_mm_loadu_si128(p + 1));
+      const __m128i y2 = grayX4_sse2(_mm_loadu_si128(p + 2));
+      const __m128i y3 = grayX4_sse2(_mm_loadu_si128(p + 3));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),
+                       _mm_packus_epi16(_mm_packs_epi32(y0, y1),
+                                        _mm_packs_epi32(y2, y3)));
+    }
+    bgraToGray8_scalar(src, dst, count - i);
+  }
+
+#endif // CSPDFIUM_SSE2
+
+  ////// AVX2 ////////////////////////////////////////////////////////////////
+
+#if defined(CSPDFIUM_AVX2)
+
+  CSPDFIUM_TARGET_AVX2
+  static inline __m256i grayX8_avx2(const __m256i v)
+  {
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256i b = _mm256_and_si256(v, mask);
+    const __m256i g = _mm256_and_si256(_mm256_srli_epi32(v,  8), mask);
+    const __m256i r = _mm256_and_si256(_mm256_srli_epi32(v, 16), mask);
+    const __m256i y = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi16(r, _mm256_set1_epi32(77)),
+                                                        _mm256_mullo_epi16(g, _mm256_set1_epi32(150))),
+                                       _mm256_mullo_epi16(b, _mm256_set1_epi32(29)));
+    return _mm256_srli_epi32(y, 8);
+  }
+
+  CSPDFIUM_TARGET_AVX2
+  static void bgraToRgb888_avx2(const uchar *src, uchar *dst, const int count)
+  {
+    // NOTE: Each 128 bit lane yields 12 bytes; the 4 trailing bytes written by
+    //       every store are overwritten by the next one, hence the margin.
+    const __m256i shuffle = _mm256_setr_epi8(2, 1, 0,  6, 5, 4,  10, 9, 8,  14, 13, 12,  -1, -1, -1, -1,
+                                             2, 1, 0,  6, 5, 4,  10, 9, 8,  14, 13, 12,  -1, -1, -1, -1);
+    int i = 0;
+    for(; i + 8 + 2 <= count; i += 8, src += 32, dst += 24) {
+      const __m256i v = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)),
+                                            shuffle);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst),      _mm256_castsi256_si128(v));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm256_extracti128_si256(v, 1));
+    }
+    bgraToRgb888_scalar(src, dst, count - i);
+  }
+
+  CSPDFIUM_TARGET_AVX2
+  static void bgraToGray8_avx2(const uchar *src, uchar *dst, const int count)
+  {
+    // NOTE: Packing operates per 128 bit lane; restore the order of dwords.
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int i = 0;
+    for(; i + 32 <= count; i += 32, src += 128, dst += 32) {
+      const __m256i *p = reinterpret_cast<const __m256i*>(src);
+      const __m256i y0 = grayX8_avx2(_mm256_loadu_si256(p + 0));
+      const __m256i y1 = grayX8_avx2(_mm256_loadu_si256(p + 1));
+      const __m256i y2 = grayX8_avx2(_mm256_loadu_si256(p + 2));
+      const __m256i y3 = grayX8_avx2(_mm256_loadu_si256(p + 3));
+      const __m256i y = _mm256_packus_epi16(_mm256_packs_epi32(y0, y1),
+                                            _mm256_packs_epi32(y2, y3));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst),
+                          _mm256_permutevar8x32_epi32(y, order));
+    }
+    bgraToGray8_scalar(src, dst, count - i);
+  }
+
+  static bool hasAvx2()
+  {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if( info[0] < 7 ) {
+      return false;
+    }
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool     avx = (info[2] & (1 << 28)) != 0;
+    if( !osxsave  ||  !avx  ||  (_xgetbv(0) & 0x6) != 0x6 ) {
+      return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+  }
+
+#endif // CSPDFIUM_AVX2
+
+  ////// Dispatch ////////////////////////////////////////////////////////////
+
+  struct Kernels {
+    Kernels()
+      : bgraToRgb888(bgraToRgb888_scalar)
+      , bgraToGray8(bgraToGray8_scalar)
+    {
+#if defined(CSPDFIUM_SSE2)
+      bgraToRgb888 = bgraToRgb888_sse2;
+      bgraToGray8  = bgraToGray8_sse2;
+#endif
+#if defined(CSPDFIUM_AVX2)
+      if( hasAvx2() ) {
+        bgraToRgb888 = bgraToRgb888_avx2;
+        bgraToGray8  = bgraToGray8_avx2;
+      }
+#endif
+    }
+
+    ConvertFunc bgraToRgb888;
+    ConvertFunc bgraToGray8;
+  };
+
+  static const Kernels& kernels()
+  {
+    static const Kernels k;
+    return k;
+  }
+
+} // namespace priv
+
+////// Public ////////////////////////////////////////////////////////////////
+
+namespace util {
+
+  void convertBgraToRgb888(const uchar *src, uchar *dst, const int count)
+  {
+    priv::kernels().bgraToRgb888(src, dst, count);
+  }
+
+  void convertBgraToGray8(const uchar *src, uchar *dst, const int count)
+  {
+    priv::kernels().bgraToGray8(src, dst, count);
+  }
+
+} // namespace util
@@ -35,86 +35,106 @@
 
 namespace util {
 
-  inline bool isSeparator(const QChar& c)
+  Q_STATIC_ASSERT( int(csPDFiumTextChars::Separator) == FPDF_TEXTCHAR_SEPARATOR );
+  Q_STATIC_ASSERT( int(csPDFiumTextChars::LineBreak) == FPDF_TEXTCHAR_LINEBREAK );
+  Q_STATIC_ASSERT( int(csPDFiumTextChars::Generated) == FPDF_TEXTCHAR_GENERATED );
+
+  void extractTextChars(const FPDF_TEXTPAGE textPage, const QMatrix& ctm,
+                        csPDFiumTextChars& chars)
   {
-    return c.isNull()  ||  c.isSpace();
+    chars.clear();
+
+    const int count = FPDFText_CountChars(textPage);
+    if( count < 1 ) {
+      return;
+    }
+
+    chars.resize(count);
+    const int numChars = FPDFText_GetCharsBulk(textPage, 0, count,
+                                               chars.unicodes.data(),
+                                               chars.boxes.data(),
+                                               chars.fontSizes.data(),
+                                               chars.flags.data());
+    if( numChars != count ) {
+      chars.resize(numChars);
+    }
+
+    // Page -> Scene; NOTE: The CTM only rotates by multiples of 90 degrees!
+    float *b = chars.boxes.data();
+    for(int i = 0; i < numChars; i++, b += 4) {
+      const qreal x1 = ctm.m11()*b[0] + ctm.m21()*b[1] + ctm.dx();
+      const qreal y1 = ctm.m12()*b[0] + ctm.m22()*b[1] + ctm.dy();
+      const qreal x2 = ctm.m11()*b[2] + ctm.m21()*b[3] + ctm.dx();
+      const qreal y2 = ctm.m12()*b[2] + ctm.m22()*b[3] + ctm.dy();
+
+      b[0] = float(qMin(x1, x2));
+      b[1] = float(qMin(y1, y2));
+      b[2] = float(qMax(x1, x2));
+      b[3] = float(qMax(y1, y2));
+    }
   }
 
-  inline void commit(csPDFiumTexts& texts, csPDFiumText& text)
+  inline void commit(csPDFiumTextLayer& layer, const QRectF& rect,
+                     const int first, const int last)
   {
+    if( first >= last ) {
+      return;
+    }
+
+    const QString word = layer.text.mid(first, last - first);
+    layer.words.push_back(word);
+
+    // NOTE: A word without a box is NOT a text; cf. csPDFiumText::isEmpty().
+    const csPDFiumText text(rect, word, layer.texts.size(), first);
     if( !text.isEmpty() ) {
-      text.setPos(texts.size());
-      texts.push_back(text);
-      text.clear();
+      layer.texts.push_back(text);
     }
   }
 
-  csPDFiumTexts extractTexts(const FPDF_PAGE page, const QMatrix& ctm)
+  void extractTextLayer(const FPDF_PAGE page, const QMatrix& ctm,
+                        csPDFiumTextLayer& layer)
   {
-    const FPDF_TEXTPAGE textPage = FPDFText_LoadPage(page);
-    if( textPage == NULL ) {
-      return csPDFiumTexts();
-    }
+    layer.clear();
+    layer.isLoaded = true;
 
-    csPDFiumTexts texts;
+    {
+      CSPDFIUM_GLOBALLOCK();
 
-    csPDFiumText text;
-    const int count = FPDFText_CountChars(textPage);
-    for(int i = 0; i < count; i++) {
-      const QChar c = QChar(FPDFText_GetUnicode(textPage, i));
-      if( isSeparator(c) ) {
-        commit(texts, text);
-        continue;
+      const FPDF_TEXTPAGE textPage = FPDFText_LoadPage(page);
+      if( textPage == NULL ) {
+        return;
       }
 
-      double left, top, right, bottom;
-      FPDFText_GetCharBox(textPage, i, &left, &right, &bottom, &top);
+      extractTextChars(textPage, ctm, layer.chars);
 
-      const QPointF topLeft     = QPointF(left,  top)   *ctm;
-      const QPointF bottomRight = QPointF(right, bottom)*ctm;
-      const QRectF r(topLeft, bottomRight);
-
-      text.merge(r, c);
+      FPDFText_ClosePage(textPage);
     }
-    commit(texts, text);
-
-    FPDFText_ClosePage(textPage);
-
-    return texts;
-  }
 
-  inline void commit(QStringList& words, QString& word)
-  {
-    if( !word.isEmpty() ) {
-      words.push_back(word);
-      word.clear();
-    }
-  }
+    const csPDFiumTextChars& chars = layer.chars;
+    const int count = chars.size();
 
-  QStringList extractWords(const FPDF_PAGE page)
-  {
-    const FPDF_TEXTPAGE textPage = FPDFText_LoadPage(page);
-    if( textPage == NULL ) {
-      return QStringList();
+    layer.text.resize(count);
+    QChar *data = layer.text.data();
+    for(int i = 0; i < count; i++) {
+      // NOTE: Keep 'text' indexable by character; cf. csPDFiumText::offset().
+      data[i] = chars.unicodes[i] != 0
+          ? QChar(chars.unicodes[i])
+          : QChar(QChar::Space);
     }
 
-    QStringList words;
-
-    QString word;
-    const int count = FPDFText_CountChars(textPage);
+    QRectF rect;
+    int first = 0;
     for(int i = 0; i < count; i++) {
-      const QChar c = QChar(FPDFText_GetUnicode(textPage, i));
-      if( isSeparator(c) ) {
-        commit(words, word);
-      } else {
-        word += c;
+      if( chars.testFlag(i, csPDFiumTextChars::Separator) ) {
+        commit(layer, rect, first, i);
+        rect  = QRectF();
+        first = i+1;
+        continue;
       }
-    }
-    commit(words, word);
-
-    FPDFText_ClosePage(textPage);
 
-    return words;
+      rect |= chars.rect(i);
+    }
+    commit(layer, rect, first, count);
   }
 
 } // namespace util
@@ -34,6 +34,8 @@
 
 #include <QtWidgets/QMainWindow>
 
+class csPdfQuickSearch;
+
 namespace Ui {
   class WMainWindow;
 } // namespace Ui
@@ -48,6 +50,7 @@ private slots:
   void copySelection();
   void openFile();
   void setEditMode(bool);
+  void showQuickSearchCount(int count);
 
 protected:
   void dragEnterEvent(QDragEnterEvent *event);
@@ -59,6 +62,7 @@ private:
   void openFile(const QString& filename);
 
   Ui::WMainWindow *ui;
+  csPdfQuickSearch *_quickSearch;
 };
 
 #endif // WMAINWINDOW_H
@@ -34,6 +34,8 @@
 
 #include <QtWidgets/QWidget>
 
+class QTimer;
+
 namespace Ui {
   class WQuickSearch;
 } // namespace Ui
@@ -44,11 +46,15 @@ public:
   WQuickSearch(QWidget *parent = nullptr, Qt::WindowFlags f = 0);
   ~WQuickSearch();
 
+private slots:
+  void emitSearchText();
+
 protected:
   bool eventFilter(QObject *watched, QEvent *event);
 
 private:
   Ui::WQuickSearch *ui;
+  QTimer *_timer; // Debounces searchTextEdited()
 
 signals:
   void searchTextEdited(const QString& text);
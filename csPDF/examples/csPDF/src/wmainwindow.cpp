@@ -37,6 +37,7 @@
 
 #include <csPDFium/csPDFiumDocument.h>
 #include <csPDFium/csPDFiumContentsModel.h>
+#include <csPDFSearch/csPdfQuickSearch.h>
 
 #include "wmainwindow.h"
 #include "ui_wmainwindow.h"
@@ -45,7 +46,8 @@
 
 WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
   : QMainWindow(parent, flags),
-    ui(new Ui::WMainWindow)
+    ui(new Ui::WMainWindow),
+    _quickSearch(nullptr)
 {
   ui->setupUi(this);
 
@@ -65,8 +67,16 @@ WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
   ui->pdfView->installEventFilter(ui->quickSearchWidget);
   ui->quickSearchWidget->hide();
 
+  _quickSearch = new csPdfQuickSearch(this);
+
   connect(ui->quickSearchWidget, &WQuickSearch::searchTextEdited,
-          ui->pdfView, &csPdfUiDocumentView::highlightText);
+          _quickSearch, &csPdfQuickSearch::find);
+  connect(ui->pdfView, &csPdfUiDocumentView::pageChanged,
+          _quickSearch, &csPdfQuickSearch::setPage);
+  connect(_quickSearch, &csPdfQuickSearch::highlightRequested,
+          ui->pdfView, &csPdfUiDocumentView::highlightRects);
+  connect(_quickSearch, &csPdfQuickSearch::documentFinished,
+          this, &WMainWindow::showQuickSearchCount);
 
   // Table of Contents ///////////////////////////////////////////////////////
 
@@ -85,7 +95,7 @@ WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
   connect(ui->searchWidget, &csPdfUiSearchWidget::pageRequested,
           ui->pdfView, &csPdfUiDocumentView::showPage);
   connect(ui->searchWidget, &csPdfUiSearchWidget::highlightRequested,
-          ui->pdfView, &csPdfUiDocumentView::highlightText);
+          ui->pdfView, &csPdfUiDocumentView::highlightRects);
 
   // Edit Mode ///////////////////////////////////////////////////////////////
 
@@ -112,6 +122,9 @@ WMainWindow::WMainWindow(QWidget *parent, Qt::WindowFlags flags)
           ui->pdfView, &csPdfUiDocumentView::setZoomBestFit);
   connect(ui->zoomFitToPageWidthAction, &QAction::triggered,
           ui->pdfView, &csPdfUiDocumentView::setZoomFitToPageWidth);
+  // NOTE: false == SinglePage, true == Continuous
+  connect(ui->continuousAction, &QAction::toggled,
+          ui->pdfView, &csPdfUiDocumentView::setLayoutMode);
 }
 
 WMainWindow::~WMainWindow()
@@ -155,6 +168,11 @@ void WMainWindow::setEditMode(bool)
   }
 }
 
+void WMainWindow::showQuickSearchCount(int count)
+{
+  ui->statusbar->showMessage(tr("%1 match(es) in document").arg(count), 5000);
+}
+
 ////// protected /////////////////////////////////////////////////////////////
 
 void WMainWindow::dragEnterEvent(QDragEnterEvent *event)
@@ -192,6 +210,7 @@ void WMainWindow::keyPressEvent(QKeyEvent *event)
 {
   if( event->key() == Qt::Key_Escape ) {
     if( ui->quickSearchWidget->isVisible() ) {
+      _quickSearch->cancel();
       ui->quickSearchWidget->hide();
     } else {
       ui->pdfView->removeMarks();
@@ -206,6 +225,7 @@ void WMainWindow::keyPressEvent(QKeyEvent *event)
 void WMainWindow::openFile(const QString& filename)
 {
   csPDFiumDocument doc = csPDFiumDocument::load(filename);
+  _quickSearch->setDocument(doc);
   ui->pdfView->setDocument(doc);
   ui->contentsWidget->setDocument(doc);
   ui->searchWidget->setDocument(doc);
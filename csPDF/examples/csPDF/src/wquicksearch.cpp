@@ -29,6 +29,7 @@
 ** OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 *****************************************************************************/
 
+#include <QtCore/QTimer>
 #include <QtGui/QKeyEvent>
 
 #include "wquicksearch.h"
@@ -38,16 +39,23 @@
 
 WQuickSearch::WQuickSearch(QWidget *parent, Qt::WindowFlags f)
   : QWidget(parent, f),
-    ui(new Ui::WQuickSearch)
+    ui(new Ui::WQuickSearch),
+    _timer(nullptr)
 {
   // Initialize UI ///////////////////////////////////////////////////////////
 
   ui->setupUi(this);
 
+  _timer = new QTimer(this);
+  _timer->setSingleShot(true);
+  _timer->setInterval(150);
+
   // Signals & Slots /////////////////////////////////////////////////////////
 
   connect(ui->searchEdit, &QLineEdit::textEdited,
-          this, &WQuickSearch::searchTextEdited);
+          _timer, static_cast<void (QTimer::*)()>(&QTimer::start));
+  connect(_timer, &QTimer::timeout,
+          this, &WQuickSearch::emitSearchText);
 }
 
 WQuickSearch::~WQuickSearch()
@@ -55,6 +63,13 @@ WQuickSearch::~WQuickSearch()
   delete ui;
 }
 
+////// private slots /////////////////////////////////////////////////////////
+
+void WQuickSearch::emitSearchText()
+{
+  emit searchTextEdited(ui->searchEdit->text());
+}
+
 ////// protected /////////////////////////////////////////////////////////////
 
 bool WQuickSearch::eventFilter(QObject *watched, QEvent *event)
@@ -66,7 +81,7 @@ bool WQuickSearch::eventFilter(QObject *watched, QEvent *event)
       show();
       ui->searchEdit->setFocus(Qt::OtherFocusReason);
       ui->searchEdit->setText(kev->text());
-      emit searchTextEdited(ui->searchEdit->text());
+      _timer->start();
     }
   }
 